@@ -8,6 +8,10 @@
 #include <stdlib.h> // uitoa
 #include <stdio.h> // printf()
 
+#ifdef PROFILE
+#include <gbdk/emu_debug.h> // EMU_printf(), EMU_PROFILE_BEGIN()
+#endif
+
 //* ------------------------------------------------------------------------------------------- *//
 //* -----------------------------------------  NOTES  ----------------------------------------- *//
 //* ------------------------------------------------------------------------------------------- *//
@@ -80,20 +84,241 @@
 	NR51_REG = 0x00; /* turns off L/R for all channels */ \
 	NR50_REG = 0x00; /* sets volume to min for L/R */
 
-#define VOLUME_MAX \
-    NR50_REG = 0x77;
+#define SOUND_TAIL_FRAMES 30 // frames to let the last sfx ring out before the APU is switched off, longer than any effect
+
+// NOTE: `make TICK_SFX=isr` (-DTICK_SFX_ISR), the seconds beep is written from the timer isr on the
+// second itself, otherwise sound_isr() plays it on the next vblank, up to a frame late
+
+#define SFX_QUEUE_SIZE 4 // power of 2
+#define SFX_PRIORITY_TICK 1
+#define SFX_PRIORITY_UI 2 // start / stop / lap / reset, a tick never cuts one short
+#define SFX_PRIORITY_ALARM 3
+
+//+ --  INTERRUPTS  -- +//
+
+#define IE_ACTIVE (VBL_IFLAG | LCD_IFLAG | SIO_IFLAG | TIM_IFLAG | JOY_IFLAG)
+#define IE_IDLE (SIO_IFLAG | JOY_IFLAG) // nothing to draw, only a button press wakes us
+#define IE_LCD_OFF (SIO_IFLAG | TIM_IFLAG | JOY_IFLAG) // no vblank with the LCD off, keep counting
+
+//+ --  TIMER  -- +//
+
+// NOTE: `make TICK_HZ=256`, the sub-second table is generated for it, see SubsecondTable
+#ifndef TICK_HZ
+#define TICK_HZ 128
+#endif
+#if (TICK_HZ & (TICK_HZ - 1)) || TICK_HZ < 32 || TICK_HZ > 1024
+#error "TICK_HZ: power of 2, 32 - 1024, so the isr wraps with a mask and both speeds fit TMA_REG"
+#endif
+#define TICK_MASK (TICK_HZ - 1)
+#define TICK_HZ_HIRES 512 // and up, wants double speed on GBC while running
+
+//+ --  COUNTDOWN  -- +//
+
+#define COUNTDOWN_DEFAULT_SECONDS 300 // 05:00
+#define COUNTDOWN_MAX_SECONDS 5990 // 1:39:50
+
+//+ --  CHANNELS  -- +//
+
+#define CHANNEL_COUNT 4 // isr cost is linear in this, see CHANNELS
+#define CHANNEL_ROW(IDX) (4 + ((IDX) << 1)) // digits at x 6, same column as the other screens
+
+//+ --  CPU SPEED  -- +//
+
+// reasons to be in double speed, GBC stays in normal speed unless one of these is set
+#define CPU_DEMAND_HIRES 0x01 // tick rate >= TICK_HZ_HIRES, only while running
+#define CPU_DEMAND_RENDER 0x02 // a screen with a lot to draw every frame while running, channels / lap list
+
+#define CPU_SWITCH_STALL_COUNTS 2 // STOP stalls the timer ~2050 clocks during a speed switch, in 4096hz counts
+
+//+ --  SRAM  -- +//
+
+#define SRAM_ADDR 0xA000 // every bank is mapped here
+#define SRAM_BANK_SETTINGS 0 // header, small stuff
+#define SRAM_BANK_JOURNAL 1 // lap journal, the whole bank
+#define SRAM_BANK_SPLITS 2 // reference split sets
+
+#define SRAM_MAGIC_0 'G'
+#define SRAM_MAGIC_1 'S'
+
+#define JOURNAL_CAPACITY 2048 // 8KB bank / 4 byte records
+#define JOURNAL_CHECK_SALT 0x5A
+
+//+ --  SPLITS  -- +//
+
+#define SPLIT_SETS 4
+#define SPLIT_MAX 64 // splits per set, also how much of the run is kept in RAM to save
+#define SPLIT_CHECK_SALT 0xC4 // was 0xC3 while the splits were kept in ticks, those sets read as empty
+#define SPLIT_ROW 10 // delta, sign + MM:SS:hh at x 10
+
+//+ --  HISTOGRAM  -- +//
+
+#define HISTO_BUCKETS 6 // rows 7 - 12
+#define HISTO_ROW 7
+#define HISTO_ANCHOR 2 // bucket the session's first lap lands in
+#define HISTO_BAR_X 7
+#define HISTO_BAR_TILES 12 // to the edge, 96 px
+#define HISTO_PX_PER_LAP 4 // full at 24 laps
+#define HISTO_BAR_TILE 0x80 // 9 partial fill tiles, past the font, same VRAM in either LCDC tile mode
+#define HISTO_WIDTHS 6
+
+//+ --  RASTER  -- +//
+
+#define RASTER_ROW 13 // rows above it are done drawing at RASTER_LY, the overlay / controls start here
+#define RASTER_LY (RASTER_ROW * 8)
+#define RASTER_QUEUE_SIZE 32 // power of 2, one slot always free, the whole queue goes in one pass
+
+//+ --  OVERLAY  -- +//
+
+#define OVERLAY_ROW 13 // the window covers from here to the bottom, the divider, controls and row 17
+#define OVERLAY_ROWS (18 - OVERLAY_ROW)
+#define OVERLAY_WIN_Y (OVERLAY_ROW * 8)
+
+//+ --  LAP LIST  -- +//
+
+#define LAPLIST_ROWS 16 // on screen, the window covers the last 2
+#define LAPLIST_RING 32 // bkg map rows, SCY_REG wraps at 256 px with it
+#define LAPLIST_WIN_Y 128 // WY_REG, 144 - 2 rows
+
+//+ --  RTC  -- +//
+
+// MBC3 only, `make rtc`
+#define RTC_LATCH_REG (*(volatile uint8_t *)0x6000) // write 0 then 1, copies the clock into the registers below
+#define RTC_REG_S 0x08 // selected with SWITCH_RAM(), read at SRAM_ADDR
+#define RTC_REG_M 0x09
+#define RTC_REG_H 0x0A
+#define RTC_REG_DL 0x0B
+#define RTC_REG_DH 0x0C // bit 0 day msb, bit 6 halt
+#define RTC_DH_HALT 0x40
+
+#define RTC_NO_SECOND 0xFF // rtc_prev_second before the first poll
+#define RTC_MIN_WINDOW_SECONDS 600 // +-1 frame at each end is ~+-25ppm over 10 minutes, better after
+#define RTC_CHECK_SECONDS 60
+#define RTC_MAX_WINDOW_SECONDS 5400 // 90 minutes, then measure again from there
+
+//+ --  DRIFT  -- +//
+
+#define TICK_CORR_MAX_PPM (998400 / TICK_HZ) // keeps the step in 16 bits, 7800 at 128hz
+
+//+ --  RESUME  -- +//
+
+#define RESUME_CHECK_SALT 0xA5
+
+//+ --  CALIBRATE  -- +//
+
+#define CALIBRATE_CHECK_SALT 0x3C
+#define CALIBRATE_DEFAULT_MINUTES 10
+#define CALIBRATE_MAX_MINUTES 90
+
+//+ --  LINK  -- +//
+
+// NOTE: one byte per transfer, anything else (0xFF with no cable) is ignored
+#define LINK_CMD_START 0xA1
+#define LINK_CMD_STOP 0xA2
+#define LINK_CMD_RESET 0xA3
+#define LINK_CMD_PING 0xA4
+#define LINK_ACK 0x5A // slave answers every transfer with this
+
+//+ --  TELEMETRY  -- +//
+
+#define TELEMETRY_RING_SIZE 64 // power of 2, a few seconds of frames
+#define TELEMETRY_SOF 0xA5
+#define TELEMETRY_FRAME_OVERHEAD 4 // SOF, type, length, check
+
+#define TELEMETRY_SNAPSHOT 0x01 // running, minutes, seconds, ticks, dropped, hours
+#define TELEMETRY_LAP 0x02 // lap lo, lap hi, minutes, seconds, hundredths (BCD)
+#define TELEMETRY_EVENT 0x03 // event, minutes, seconds, ticks, hours
+
+#define TELEMETRY_EVENT_START 0x01
+#define TELEMETRY_EVENT_STOP 0x02
+#define TELEMETRY_EVENT_RESET 0x03
+
+// NOTE: ticks go out in 1/128ths whatever TICK_HZ is, the host side doesnt need to know
+#if TICK_HZ >= 128
+#define TELEMETRY_TICKS(T) ((uint8_t)((T) / (TICK_HZ / 128)))
+#else
+#define TELEMETRY_TICKS(T) ((uint8_t)((T) * (128 / TICK_HZ)))
+#endif
+
+//+ -----------------------------  PROFILE  ------------------------------ +//
+
+/* ~---------------------------------------------------------------------------
+
+	Built with `make profile` (-DPROFILE), otherwise all of this compiles to nothing.
+
+	DI AUDIT:
+	Every CRITICAL block (and the timer isr, which runs with interrupts off) is wrapped in
+	DI_AUDIT_BEGIN / DI_AUDIT_END, the longest window seen is kept along with where it came from.
+	DIV_REG ticks every 256 clocks, so the numbers are rounded to that, good enough to catch
+	anything that blows the budget. Exact cycle counts come from the EMU_PROFILE messages in Emulicious.
+
+	Budget is 512 clocks (2 DIV ticks), a 128hz tick is 32768 clocks, so a tick can never be
+	held off by more than ~1.5% of its period.
+	The one window allowed past it is the GBC speed switch (STOP), which only happens when the
+	speed policy changes, see set_cpu_speed().
+
+	TICK LATENCY:
+	TIMA_REG (4096hz) steps when bits 8-9 of DIV_REG roll over to 0, so on entry to the timer isr
+	(TIMA_REG - TMA_REG) * 4 + (DIV_REG & 0x03) is how many DIV ticks ago the overflow happened.
+	Worst case seen is shown next to the DI audit.
+
+	POWER:
+	wait_for_event() spins instead of HALTing, every pass through the spin is time the CPU would
+	have been halted. Passes per DIV_REG roll over (65536 clocks) are counted once at boot with
+	interrupts off, so idle clocks = spins * 65536 / spins_per_roll_over, and everything else was
+	active. Reported once per emulated minute (3840 roll overs, 7680 in double speed), the window
+	restarts on start / pause / sleep / wake so each minute is all one state.
+
+	WAKE LATENCY:
+	DIV_REG is latched in the JOY isr, wake_display() reports how long until the LCD is back on
+	with the current time drawn.
+
+	ALARM LATENCY:
+	Countdown zero is a TIMA_REG overflow like any other tick, so the TICK LATENCY sum taken
+	right after the alarm registers are written is overflow -> alarm. handle_alarm() logs it,
+	compare against the "timer isr clocks" EMU_PROFILE numbers for the same tick.
+
+	TICK SFX LATENCY:
+	Right after the seconds beep is triggered, hundredths, TIMA_REG and DIV_REG say how far past
+	the second boundary we are (same sum as TICK LATENCY, plus whole ticks). Max and average over
+	each 60 beeps go to the Emulicious log, build with and without TICK_SFX=isr to compare.
+
+	COUNTER:
+	"stopwatch render clocks" is the digit drawing each frame, next to "timer isr clocks" it is
+	the BCD / binary comparison, build with and without COUNTER=binary, see COUNTER in TIME.
+
+---------------------------------------------------------------------------~ */
+
+#define DI_BUDGET_DIV_TICKS 2 // 512 clocks
+
+#ifdef PROFILE
+	#define PROFILE_BEGIN(MSG) EMU_PROFILE_BEGIN(MSG)
+	#define PROFILE_END(MSG) EMU_PROFILE_END(MSG)
+
+	#define DI_AUDIT_BEGIN uint8_t di_audit_start = DIV_REG
+	#define DI_AUDIT_END(SITE) di_audit_record((uint8_t)(DIV_REG - di_audit_start), SITE)
+
+	#define TICK_LATENCY_PROBE tick_latency_record(TIMA_REG, DIV_REG)
+
+	#define POWER_PROFILE_RESET power_profile_reset()
+
+	#define TICK_SFX_PROBE tick_sfx_latency_record()
 
-#define VOLUME_HIGH \
-    NR50_REG = 0x55;
+	#define ALARM_PROBE alarm_latency = (uint8_t)((uint8_t)(TIMA_REG - TMA_REG) << 2) + (DIV_REG & 0x03)
+#else
+	#define PROFILE_BEGIN(MSG)
+	#define PROFILE_END(MSG)
 
-#define VOLUME_MED \
-    NR50_REG = 0x33; 
+	#define DI_AUDIT_BEGIN
+	#define DI_AUDIT_END(SITE)
 
-#define VOLUME_LOW \
-    NR50_REG = 0x11;
+	#define TICK_LATENCY_PROBE
 
-#define VOLUME_MIN \
-    NR50_REG = 0x00;
+	#define POWER_PROFILE_RESET
+
+	#define TICK_SFX_PROBE
+
+	#define ALARM_PROBE
+#endif
 
 //* ------------------------------------------------------------------------------------------- *//
 //* --------------------------------------  DEFINITIONS  -------------------------------------- *//
@@ -103,378 +328,3848 @@
 
 bool is_gbc;
 bool is_cpu_fast;
+uint8_t cpu_demand; // CPU_DEMAND_*
 
-//+ -------------------------------  FONT  -------------------------------- +//
-
-font_t font;
+//+ ------------------------------  EVENTS  ------------------------------- +//
 
-//+ -------------------------------  VRAM  -------------------------------- +//
+// NOTE: one byte per event, each isr only ever sets its own, so no read-modify-write races
+volatile bool vbl_event; // vblank, safe to draw
+volatile bool joy_event; // a button went down
+volatile bool tick_event; // time changed, whats on screen is stale
+volatile bool link_event; // a link command was acted on in the SIO isr
+volatile bool alarm_event; // countdown hit zero, timer already stopped in the isr
 
-uint8_t numbers_base_tile_idx = 16; // tile-index of "0" in VRAM tile-data
+//+ ------------------------------  POWER  -------------------------------- +//
 
-//+ -----------------------------  STOPWATCH  ----------------------------- +//
+uint8_t power_ie; // interrupts currently enabled, IE_ACTIVE / IE_IDLE / IE_LCD_OFF
+bool is_lcd_off; // sleeping, timer still counts in the isr
+volatile bool is_sound_on; // read in the timer isr with TICK_SFX_ISR
+uint8_t sound_tail_frames;
 
-bool stopwatch;
-bool play_stopwatch_tick_sfx;
+//+ -------------------------------  SOUND  ------------------------------- +//
 
-// NOTE: volatile tells compiler this can change in isr, dont do optimizations on it
-volatile uint8_t minutes; // Pointer to text LUT
-volatile uint8_t seconds; // BCD
-volatile uint8_t hundredths; // BCD
+typedef struct {
+	uint8_t frames; // held before the next step, 0 ends the effect
+	uint8_t regs[5]; // NRx0 - NRx4 as is, NRx4 with the trigger bit
+} sfx_step_t;
 
-//* ------------------------------------------------------------------------------------------- *//
-//* ----------------------------------------  ASSETS  ----------------------------------------- *//
-//* ------------------------------------------------------------------------------------------- *//
+typedef struct {
+	uint8_t channel; // SFX_CH_*
+	uint8_t priority; // SFX_PRIORITY_*
+	const sfx_step_t *steps;
+} sfx_t;
 
-const unsigned char white_tile[] = {
-	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+enum sfx_channel {
+	SFX_CH_1,
+	SFX_CH_2,
+	SFX_CHANNELS
 };
 
-// Generated in RGBASM using:
-/*
-  DEF MIL = 0
-  REPT 128
-  REDEF CB EQUS STRSUB("{f:MIL}", 3, 2)
-  db "{CB}"
-  DEF MIL += 1.0/128
-  ENDR
-*/
-const char MilTable128[128][3] = {
-	"00", "00", "01", "02",
-	"03", "03", "04", "05",
-	"06", "07", "07", "08",
-	"09", "10", "10", "11",
-	"12", "13", "14", "14",
-	"15", "16", "17", "17",
-	"18", "19", "20", "21",
-	"21", "22", "23", "24",
-	"25", "25", "26", "27",
-	"28", "28", "29", "30",
-	"31", "32", "32", "33",
-	"34", "35", "35", "36",
-	"37", "38", "39", "39",
-	"40", "41", "42", "42",
-	"43", "44", "45", "46",
-	"46", "47", "48", "49",
-	"50", "50", "51", "52",
-	"53", "53", "54", "55",
-	"56", "57", "57", "58",
-	"59", "60", "60", "61",
-	"62", "63", "64", "64",
-	"65", "66", "67", "67",
-	"68", "69", "70", "71",
-	"71", "72", "73", "74",
-	"75", "75", "76", "77",
-	"78", "78", "79", "80",
-	"81", "82", "82", "83",
-	"84", "85", "85", "86",
-	"87", "88", "89", "89",
-	"90", "91", "92", "92",
-	"93", "94", "95", "96",
-	"96", "97", "98", "99"
+enum sfx_id {
+	SFX_START_STOP,
+	SFX_LAP,
+	SFX_RESET,
+	SFX_TICK,
+	SFX_ALARM,
+	SFX_COUNT
 };
 
-//* ------------------------------------------------------------------------------------------- *//
-//* ------------------------------------------  SFX  ------------------------------------------ *//
-//* ------------------------------------------------------------------------------------------- *//
-
-void sfx_1(void) {
-	// CHN-1:   1, 0, 7, 1, 2, 13, 0, 5, 1847, 0, 1, 1, 0
-	NR10_REG = 0x17; // freq sweep
-	NR11_REG = 0x42; // duty, length
-	NR12_REG = 0xD5; // envelope 
-	NR13_REG = 0x37; // freq lbs
-	NR14_REG = 0x87; // init, cons, freq msbs 
-}
-
-void sfx_2(void) {
-	// CHN-1:   6, 0, 4, 2, 2, 13, 0, 5, 1847, 0, 1, 1, 0
-	NR10_REG = 0x64; // freq sweep
-	NR11_REG = 0x82; // duty, length
-	NR12_REG = 0xD5; // envelope 
-	NR13_REG = 0x37; // freq lbs
-	NR14_REG = 0x87; // init, cons, freq msbs 
-}
+uint8_t sfx_queue[SFX_QUEUE_SIZE];
+volatile uint8_t sfx_queue_head; // only the main loop moves it
+volatile uint8_t sfx_queue_tail; // sound_isr() moves it, and sfx_stop_all() with interrupts off
 
-void sfx_4(void) {
-	// CHN-1:	6, 1, 5, 2, 5, 13, 0, 1, 1885, 0, 1, 1, 0
-	NR10_REG = 0x6D; // freq sweep
-	NR11_REG = 0x85; // duty, length
-	NR12_REG = 0xD1; // envelope 
-	NR13_REG = 0x5D; // freq lbs   
-	NR14_REG = 0x87; // init, cons, freq msbs 
-}
+// NOTE: per channel, only ever touched with interrupts off
+const sfx_step_t *sfx_step[SFX_CHANNELS];
+uint8_t sfx_frames[SFX_CHANNELS]; // left on the current step, 0 is idle
+uint8_t sfx_priority[SFX_CHANNELS];
 
-//* ------------------------------------------------------------------------------------------- *//
-//* ----------------------------------------  SYSTEM  ----------------------------------------- *//
-//* ------------------------------------------------------------------------------------------- *//
+//+ -------------------------------  INPUT  ------------------------------- +//
 
-void set_cpu(void) {
+uint8_t prev_joypad; // also tells handle_power() a button is still held
 
-	CRITICAL {
-		if (_cpu == CGB_TYPE) is_gbc = TRUE;
-		if (is_gbc) {
-			cpu_fast();
-			is_cpu_fast = TRUE;
+//+ ------------------------------  SCREENS  ------------------------------ +//
 
-			set_default_palette(); // palette-0, grayscale
-		}
-	}
+enum screen {
+	SCREEN_STOPWATCH,
+	SCREEN_COUNTDOWN,
+	SCREEN_CHANNELS,
+	SCREEN_CALIBRATE,
+	SCREEN_LINK,
+	SCREEN_STATS,
+	SCREEN_HISTOGRAM,
+	SCREEN_LAPS,
+	SCREEN_COUNT
+};
 
-}
+uint8_t screen; // SELECT steps through them, only while stopped
 
-void clear_sprite_tiles(void) {
+//+ -------------------------------  FONT  -------------------------------- +//
 
-	for (uint8_t i = 0; i < 127; i++) {
-		set_sprite_data(i, 1, white_tile);
-	}
+font_t font;
 
-}
+//+ -------------------------------  VRAM  -------------------------------- +//
 
-void init_system(void) {
+uint8_t numbers_base_tile_idx = 16; // tile-index of "0" in VRAM tile-data
+uint8_t *stopwatch_xy_addr; // big digits, bkg on most screens, the window on the lap list
 
-	set_cpu();
+//+ -----------------------------  STOPWATCH  ----------------------------- +//
 
-	clear_sprite_tiles(); // clear VRAM
-	init_bkg(0); // reset bkg_map with tile-0
+// NOTE: tick within the second, 0 - (TICK_HZ - 1), index into SubsecondTable
+#if TICK_HZ > 256
+typedef uint16_t tick_t;
+#else
+typedef uint8_t tick_t;
+#endif
 
-	set_interrupts(VBL_IFLAG | LCD_IFLAG | SIO_IFLAG | TIM_IFLAG);
+uint8_t stopwatch_tiles[8]; // tiles currently on screen, only digits that changed get written
 
-	SHOW_BKG;
-	SHOW_SPRITES;
+volatile bool stopwatch; // link_isr and countdown_zero write it from interrupts
+bool play_stopwatch_tick_sfx;
 
-	SOUND_ON;
-	DISPLAY_ON;
+// NOTE: volatile tells compiler this can change in isr, dont do optimizations on it
+#ifdef TICK_COUNTER_BINARY
+volatile uint32_t tick_count; // the whole time in ticks, see COUNTER
+#else
+volatile uint8_t hours; // BCD, only touched on a minutes carry
+volatile uint8_t minutes; // BCD, 00 - 59 into hours
+volatile uint8_t seconds; // BCD
+volatile tick_t hundredths; // tick within the second, not BCD, SubsecondTable turns it into hundredths
+#endif
 
-}
+uint32_t stopwatch_saved_ticks; // put aside while the calibrate / countdown screens borrow the counters
 
-//* ------------------------------------------------------------------------------------------- *//
-//* --------------------------------------  INTERRUPTS  --------------------------------------- *//
-//* ------------------------------------------------------------------------------------------- *//
+volatile bool countdown; // counters run down, countdown screen only
+uint16_t countdown_preset_seconds = COUNTDOWN_DEFAULT_SECONDS;
 
-void set_timer_reg_stopwatch(void) {
+//+ ------------------------------  CHANNELS  ----------------------------- +//
 
-	CRITICAL {
-		if (!is_cpu_fast) {
-			TMA_REG = (uint8_t)(0x100 - 32); // DMG: divide 4096hz clock by 32 (4096/32 = 128hz)
-		} else {
-			TMA_REG = (uint8_t)(0x100 - 64); // GBC: divide 4096hz clock by 64 (4096/64 = 64hz)
-		}
-	}
+// NOTE: one array per field, the isr walks each one with the same index, see CHANNELS
+volatile bool channels; // channels screen, the isr counts these instead of the stopwatch
+volatile bool channel_running[CHANNEL_COUNT];
+volatile uint8_t channel_minutes[CHANNEL_COUNT]; // BCD
+volatile uint8_t channel_seconds[CHANNEL_COUNT]; // BCD
+volatile tick_t channel_ticks[CHANNEL_COUNT];
 
-}
+uint8_t channels_running; // how many, the timer runs while any is
+uint8_t channel_selected;
+uint8_t channel_tiles[CHANNEL_COUNT][8]; // same as stopwatch_tiles, per row
 
-void stopwatch_timer_isr(void) {
+//+ -------------------------------  TIME  -------------------------------- +//
 
-	if (stopwatch) {
-		hundredths = (hundredths + 1) & 0x7F;
-		// If we overflowed
-		if (hundredths == 0) {
-			// GBDK *does* have BCD support, but it's 32bit, *way* overkill, 
-			// so instead I'll just do it in assembly and try to explain...
-			__asm
-				// ; First, we load the value of seconds from its memory address to register A
-				ld a, (#_seconds)
+typedef struct {
+	uint8_t hours; // BCD
+	uint8_t minutes; // BCD
+	uint8_t seconds; // BCD
+	tick_t ticks;
+} stopwatch_time_t;
 
-				// ; Now we add 1 to A
-				add #0x01 
+#ifdef TICK_COUNTER_BINARY
+uint32_t render_seconds; // whole seconds print_stopwatch() last converted
+stopwatch_time_t render_time;
+#endif
 
-				// ; Next, we use the DAA instruction, which based on the CPU flags left by 
-				// ; the previous instruction, corrects the value of A to be a valid BCD value, so for example:
-				// ; 0x00 + 0x01 = 0x01 -> 0x01
-				// ; 0x09 + 0x01 = 0x0A -> 0x10
-				// ; 0x99 + 0x01 = 0x9A -> 0x00
-				daa
+//+ -------------------------------  SRAM  -------------------------------- +//
 
-				// ; Finally, we write the value of A back to the memory address of seconds
-				ld (#_seconds), a
-			__endasm;
+// NOTE: two of these, written alternately, so a power cut mid-write always leaves the other one
+typedef struct {
+	uint8_t seq; // the newer slot is one ahead
+	uint8_t running;
+	uint32_t ref_rtc_seconds; // RTC at the reference point, lined up on an RTC second
+	uint32_t ref_ticks; // stopwatch at the reference point (paused: the paused time)
+	uint32_t lap_split_ticks;
+	uint8_t check; // written last
+} resume_slot_t;
 
-			play_stopwatch_tick_sfx = TRUE;
+typedef struct {
+	uint8_t magic[2];
+	uint8_t journal_generation; // bumped on reset, older records stop validating
+	resume_slot_t resume[2]; // RTC builds only, the layout is the same either way
+	int16_t cal_ppm; // user calibration, see calibrate_save()
+	uint8_t cal_check; // written last
+} sram_settings_t;
 
-			if (seconds >= 0x60) {
-				seconds = 0x00;
-				// Need to add 1 to minutes, use same snippet as above but not explained
-				__asm__("ld a, (#_minutes)\n add #0x01\n daa\n ld (#_minutes), a");
-			}
-		}
-	}
+// NOTE: packed BCD, same nibble path as the stopwatch digits
+typedef struct {
+	uint8_t minutes;
+	uint8_t seconds;
+	uint8_t hundredths;
+	uint8_t check; // written last, commits the record
+} journal_record_t;
 
-}
+// NOTE: stopwatch time at each split from the start of the run in hundredths, not ticks, so a set
+// still means the same to a build with another TICK_HZ. count and splits under one check
+typedef struct {
+	uint8_t count;
+	uint8_t check; // written last
+	uint32_t splits[SPLIT_MAX];
+} split_set_t;
 
-void set_timer_isr_stopwatch(void) {
+#define sram_settings (*(volatile sram_settings_t *)SRAM_ADDR) // SRAM_BANK_SETTINGS
+#define journal_records ((volatile journal_record_t *)SRAM_ADDR) // SRAM_BANK_JOURNAL
+#define split_sets ((volatile split_set_t *)SRAM_ADDR) // SRAM_BANK_SPLITS
 
-	CRITICAL {
-		add_TIM(stopwatch_timer_isr); // NOTE: will not be interrupted by other interrupts
-	}
+uint16_t journal_count; // committed records, next free slot
+uint8_t journal_generation; // copy of sram_settings.journal_generation
 
-}
+//+ -------------------------------  DRIFT  ------------------------------- +//
 
-void clear_timer_isr_stopwatch(void) {
+// NOTE: applied once a second in the isr, see set_tick_correction()
+volatile uint16_t tick_corr_step; // ticks per second to add / drop, in 1/65536ths of a tick
+volatile uint16_t tick_corr_acc;
+volatile bool tick_corr_add; // crystal is slow, add ticks, otherwise drop them
+volatile bool tick_hold; // drop the next tick
+volatile int16_t tick_corr_net; // ticks added - ticks dropped, gives back the raw crystal count
+int16_t tick_corr_ppm; // currently applied, + means the crystal runs fast
 
-	CRITICAL {
-		remove_TIM(stopwatch_timer_isr);
-	}
+//+ -----------------------------  CALIBRATE  ----------------------------- +//
 
-}
+int16_t cal_ppm; // copy of sram_settings.cal_ppm
+int16_t calibrate_prev_ppm; // correction in use before the calibrate screen, put back on the way out
+uint8_t calibrate_target_minutes = CALIBRATE_DEFAULT_MINUTES;
+int16_t calibrate_result_ppm;
+bool calibrate_has_result;
 
-//* ------------------------------------------------------------------------------------------- *//
-//* -----------------------------------------  INITS  ----------------------------------------- *//
-//* ------------------------------------------------------------------------------------------- *//
+//+ -------------------------------  LINK  -------------------------------- +//
 
-void init_scene(void) {
+enum link_mode {
+	LINK_OFF,
+	LINK_MASTER, // drives the clock, sends
+	LINK_SLAVE, // external clock, always armed to receive
+	LINK_TELEMETRY, // internal clock, frames out to a host, see TELEMETRY
+	LINK_MODE_COUNT
+};
 
-	gotoxy(1, 1);
-	printf("GB STOPWATCH :");
-	gotoxy(1, 2);
-	printf("------------------");
+uint8_t link_mode;
+volatile uint8_t link_tx_cmd; // master, byte on the wire
+volatile uint8_t link_rx_cmd; // last command acted on, for handle_link()
+volatile bool link_peer; // master, the last transfer came back with LINK_ACK
 
-	gotoxy(6, 6);
-	printf("00:00:00");
+// NOTE: main loop only moves head, the SIO isr only moves tail
+uint8_t telemetry_ring[TELEMETRY_RING_SIZE];
+volatile uint8_t telemetry_head; // next free byte, only moved once a whole frame is in
+volatile uint8_t telemetry_tail; // next byte out
+volatile bool telemetry_tx_busy; // a byte is on the wire, the isr keeps it going
+uint8_t telemetry_dropped; // frames that didnt fit, saturates, sent with every snapshot
+uint8_t telemetry_last_seconds; // snapshot once a second
 
-	gotoxy(1, 14);
-	printf("------------------");
-	gotoxy(5, 15);
-	printf("A:   Start");
-	gotoxy(5, 16);
-	printf("B:   Reset");
+//+ --------------------------------  RTC  -------------------------------- +//
 
-}
+#ifdef USE_RTC
 
-//* ------------------------------------------------------------------------------------------- *//
-//* ---------------------------------------  ROUTINES  ---------------------------------------- *//
-//* ------------------------------------------------------------------------------------------- *//
+uint8_t rtc_prev_second;
+bool rtc_window_open; // reference taken
+uint32_t rtc_ref_seconds;
+uint32_t rtc_ref_ticks;
+int16_t rtc_ref_corr_net;
 
-void reset_stopwatch(void) {
+uint8_t resume_slot_idx; // newest slot
+uint8_t resume_seq;
+bool resume_running;
+uint32_t resume_ref_rtc_seconds;
+uint32_t resume_ref_ticks;
+bool resume_ref_pending; // started, move the reference onto the next RTC edge
+bool resume_align_pending; // resumed at boot on a mid second guess, fix on the next RTC edge
 
-	sfx_4();
+#endif
 
-	TIMA_REG = 0; // reset TIMA_REG
-	stopwatch = FALSE; // saftey, should already be false
+//+ -------------------------------  LAPS  -------------------------------- +//
 
-	minutes = 0;
-	seconds = 0;
-	hundredths = 0;
+uint16_t lap_count;
+uint32_t lap_split_ticks; // stopwatch time at the last lap
+bool lap_pending; // taken, not yet in the journal
+journal_record_t lap_pending_record;
 
-	gotoxy(6, 6);
-	printf("00:00:00");
+//+ ------------------------------  SPLITS  ------------------------------- +//
 
-}
+uint32_t run_splits[SPLIT_MAX]; // this run in hundredths, what gets saved as a reference
+uint8_t run_split_count; // same as lap_count, unless the laps came back from the journal at boot
 
-void pause_stopwatch(void) {
+uint8_t split_set; // selected reference set
+uint8_t split_ref_count; // splits in it, 0 when empty or it didnt check
+uint32_t split_ref_next; // reference for the split being run
+bool split_ref_pending; // lap taken, load the next reference after drawing
 
-	// NOTE: dont reset TIMA_REG, pick up where it left off
+bool split_delta_on; // there is a reference for this split, SPLIT_ROW shows the delta
+bool split_delta_resync; // work the delta out in full on the next frame
+bool split_delta_neg; // ahead of the reference
+stopwatch_time_t split_delta; // |now - reference|, hours unused
+tick_t split_delta_phase; // stopwatch tick the delta was last stepped to
+uint8_t split_delta_tiles[9]; // sign, MM:SS:hh, same as stopwatch_tiles
 
-	CRITICAL {
-		TAC_REG = TACF_STOP; // stop timer
-		stopwatch = FALSE;
-	}
 
-	VOLUME_MAX;
-	sfx_1();
+//+ -----------------------------  LAP STATS  ----------------------------- +//
 
-	gotoxy(10, 15);
-	printf("Start");
-	gotoxy(5, 16);
-	printf("B:   Reset");
+// NOTE: this session's laps in hundredths, see LAP STATS
+uint16_t lap_stats_count;
+uint32_t lap_stats_best;
+uint32_t lap_stats_worst;
+uint16_t lap_stats_best_lap;
+uint16_t lap_stats_worst_lap;
+uint32_t lap_stats_mean_q8; // mean << 8
+uint32_t lap_stats_var; // population variance, hundredths squared
 
-}
+//+ -----------------------------  HISTOGRAM  ----------------------------- +//
 
-void start_stopwatch(void) {
+const uint8_t histo_widths[HISTO_WIDTHS] = { 1, 2, 5, 10, 30, 60 }; // bucket width, seconds
 
-	CRITICAL {
-		TAC_REG = TACF_4KHZ | TACF_START; // start timer
-		stopwatch = TRUE;
-	}
+uint8_t histo_width_idx = 1;
+uint8_t histo_counts[HISTO_BUCKETS]; // saturates, the bar is full long before
+uint32_t histo_anchor; // first lap / width, in widths
+bool histo_anchored;
+uint8_t histo_dirty; // bucket bits, bars to redraw
+uint8_t histo_tiles[HISTO_BUCKETS][HISTO_BAR_TILES]; // on screen, same idea as stopwatch_tiles
 
-	VOLUME_MAX;
-	sfx_1();
-	
-	gotoxy(10, 15);
-	printf("Stop ");
-	gotoxy(5, 16);
-	printf("          ");
+//+ ------------------------------  RASTER  ------------------------------- +//
 
-}
+// NOTE: main loop pushes, raster_isr() pops, each side only writes its own index
+uint8_t *raster_addr[RASTER_QUEUE_SIZE];
+uint8_t raster_tile[RASTER_QUEUE_SIZE];
+volatile uint8_t raster_head;
+volatile uint8_t raster_tail;
+bool raster_full; // a push didnt fit, the tile stays dirty for next frame
 
-void handle_inputs(void) {
+//+ -----------------------------  OVERLAY  ------------------------------- +//
 
-	static uint8_t prev_joypad = NULL;
-	uint8_t current_joypad = joypad();
+bool overlay_on; // this screen has running controls on the window, see OVERLAY
 
-	if ((current_joypad & J_A) && !(prev_joypad & J_A)) {
-		if (stopwatch) pause_stopwatch();
-		else start_stopwatch();
-	}
-	if ((current_joypad & J_B) && !(prev_joypad & J_B) && !stopwatch) {
-		reset_stopwatch();
-	}
+//+ -----------------------------  LAP LIST  ------------------------------ +//
 
-	prev_joypad = current_joypad;
+uint16_t laplist_count; // laps in the ring, the newest is (laplist_count - 1) % LAPLIST_RING
 
-}
+//+ -----------------------------  PROFILE  ------------------------------ +//
 
-inline void print_stopwatch(void) {
+#ifdef PROFILE
 
-	// BCD2Text is... weird, so we'll do it ourselves, cheaper than casting probs
+// NOTE: keep in sync with di_site_names[]
+enum di_site {
+	DI_SITE_NONE,
+	DI_SITE_TIMER_ISR_SET,
+	DI_SITE_TIMER_ISR_CLEAR,
+	DI_SITE_PAUSE,
+	DI_SITE_START,
+	DI_SITE_TIMER_ISR,
+	DI_SITE_CPU_SPEED,
+	DI_SITE_SNAPSHOT,
+	DI_SITE_TICK_CORR,
+	DI_SITE_SET_TIME,
+	DI_SITE_SOUND,
+	DI_SITE_RASTER,
+	DI_SITE_LINK_MODE,
+	DI_SITE_TELEMETRY,
+};
 
-	uint8_t *starting_bkg_xy_addr = get_bkg_xy_addr(6, 6);
+const char * const di_site_names[] = {
+	"----",
+	"TSET",
+	"TCLR",
+	"PAUS",
+	"STRT",
+	"TISR",
+	"CPU ",
+	"SNAP",
+	"CORR",
+	"TIME",
+	"SND ",
+	"RAST",
+	"LMOD",
+	"TLM ",
+};
 
-	set_vram_byte((starting_bkg_xy_addr), ((minutes >> 4) & 0x0F) + numbers_base_tile_idx); // minutes
-	set_vram_byte((starting_bkg_xy_addr + 1), (minutes & 0x0F) + numbers_base_tile_idx);
+volatile uint8_t di_audit_max; // longest window, in DIV ticks (256 clocks)
+volatile uint8_t di_audit_max_site;
+volatile bool di_audit_dirty;
 
-	set_vram_byte((starting_bkg_xy_addr + 3), ((seconds >> 4) & 0x0F) + numbers_base_tile_idx); // seconds
-	set_vram_byte((starting_bkg_xy_addr + 4), (seconds & 0x0F) + numbers_base_tile_idx);
+volatile uint8_t tick_latency_max; // overflow -> timer isr, in DIV ticks (256 clocks)
 
-	set_vram_byte((starting_bkg_xy_addr + 6), MilTable128[hundredths][0] - '0' + numbers_base_tile_idx); // miliseconds
-	set_vram_byte((starting_bkg_xy_addr + 7), MilTable128[hundredths][1] - '0' + numbers_base_tile_idx);
+uint32_t power_spins; // passes through the idle spin this window
+uint16_t power_spins_per_wrap; // calibrated at boot
+uint16_t power_div_wraps; // DIV_REG roll overs this window
+uint16_t power_window_wraps; // one minute worth of roll overs
+uint8_t power_div_prev;
 
-}
+volatile uint8_t wake_div_start; // DIV_REG at the button press that woke the display
 
-void handle_stopwatch(void) {
+#define TICK_SFX_REPORT_BEEPS 60
 
-	if (stopwatch) {
-		print_stopwatch();
+volatile uint16_t tick_sfx_latency_max; // second boundary -> beep triggered, in DIV ticks (256 clocks)
+volatile uint32_t tick_sfx_latency_sum;
+volatile uint8_t tick_sfx_latency_beeps;
+volatile bool tick_sfx_report; // handle_profile() logs it, never from the isr
 
-		if (play_stopwatch_tick_sfx) {
-			VOLUME_LOW;
-			sfx_2();
-			play_stopwatch_tick_sfx = FALSE;
-		}
-	}
+volatile uint8_t alarm_latency; // countdown zero overflow -> alarm written, in DIV ticks (256 clocks)
 
-}
+#endif
 
 //* ------------------------------------------------------------------------------------------- *//
-//* -----------------------------------------  GAME  ------------------------------------------ *//
+//* ----------------------------------------  ASSETS  ----------------------------------------- *//
 //* ------------------------------------------------------------------------------------------- *//
 
-void init_game(void) {
+const unsigned char white_tile[] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
 
-	font_init();
-	font = font_load(font_spect);
+// NOTE: tick -> hundredths as packed BCD, one byte each, in ROM. Generated at build time for TICK_HZ
+// by tools/gen_subsecond.py into build/gen/subsecond.c, so any rate it takes gets its own table.
+// Same nibbles as minutes / seconds, drawn the same way, 128 bytes at 128hz (was 384 as ASCII "00\0").
+// Per frame the hundredths went from two ticks * 3 index sums, two loads and two - '0' to one load
+// and a swap / mask, ~100 -> ~40 clocks by hand, "stopwatch render clocks" in PROFILE has the real ones
+extern const uint8_t SubsecondTable[TICK_HZ];
 
-	set_timer_reg_stopwatch(); // set counter and modulo registers
-	set_timer_isr_stopwatch(); // set isr
-	TIMA_REG = 0; // reset TIMA_REG
+// NOTE: histogram bars, 0 - 8 px filled from the left, color 3, a blank row top and bottom between bars
+const unsigned char histo_bar_tiles[] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0 px
+	0x00, 0x00, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00, 0x00, // 1 px
+	0x00, 0x00, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0x00, 0x00, // 2 px
+	0x00, 0x00, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0x00, 0x00, // 3 px
+	0x00, 0x00, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0x00, 0x00, // 4 px
+	0x00, 0x00, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0x00, 0x00, // 5 px
+	0x00, 0x00, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0x00, 0x00, // 6 px
+	0x00, 0x00, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0x00, 0x00, // 7 px
+	0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, // 8 px
+};
 
-	init_scene(); // header and controls text
+//+ --  SFX  -- +//
 
-}
+// NOTE: channel register blocks, NRx0 for CH2 is an unused address, writes to it do nothing
+volatile uint8_t * const sfx_channel_regs[SFX_CHANNELS] = {
+	(volatile uint8_t *)0xFF10,
+	(volatile uint8_t *)0xFF15
+};
 
-//* ------------------------------------------------------------------------------------------- *//
-//* -----------------------------------------  MAIN  ------------------------------------------ *//
-//* ------------------------------------------------------------------------------------------- *//
+const sfx_step_t sfx_start_stop_steps[] = {
+	// CHN-1:   1, 0, 7, 1, 2, 13, 0, 5, 1847, 0, 1, 1, 0
+	{ 8, { 0x17, 0x42, 0xD5, 0x37, 0x87 } },
+	{ 0 }
+};
 
-void main(void) {
+const sfx_step_t sfx_lap_steps[] = {
+	{ 4, { 0x17, 0x42, 0xD5, 0x37, 0x87 } }, // same as start / stop
+	{ 8, { 0x17, 0x42, 0xD5, 0x6B, 0x87 } }, // and a second, higher one, 1899
+	{ 0 }
+};
 
-	init_system();
-	init_game();
+const sfx_step_t sfx_reset_steps[] = {
+	// CHN-1:	6, 1, 5, 2, 5, 13, 0, 1, 1885, 0, 1, 1, 0
+	{ 8, { 0x6D, 0x85, 0xD1, 0x5D, 0x87 } },
+	{ 0 }
+};
 
-	while (TRUE) {
-		handle_inputs();
-		vsync();
-		handle_stopwatch();
+const sfx_step_t sfx_tick_steps[] = {
+	// CHN-1:   6, 0, 4, 2, 2, 3, 0, 7, 1847, 0, 1, 1, 0
+	// NOTE: used to be 13 / 5 at VOLUME_LOW, the quiet is in the envelope now, master volume stays put
+	{ 4, { 0x64, 0x82, 0x37, 0x37, 0x87 } },
+	{ 0 }
+};
+
+// NOTE: on CH2, no sweep so the bytes are the same, a button press during it still gets CH1
+const sfx_step_t sfx_alarm_steps[] = {
+	// CHN-2:   0, 0, 0, 2, 0, 15, 0, 3, 1985, 0, 1, 1, 0
+	{ 6, { 0x00, 0x80, 0xF3, 0xC1, 0x87 } },
+	{ 4, { 0x00, 0x80, 0x08, 0xC1, 0x87 } }, // volume 0, DAC stays on
+	{ 6, { 0x00, 0x80, 0xF3, 0xC1, 0x87 } },
+	{ 4, { 0x00, 0x80, 0x08, 0xC1, 0x87 } },
+	{ 8, { 0x00, 0x80, 0xF3, 0xC1, 0x87 } },
+	{ 0 }
+};
+
+const sfx_t sfx_table[SFX_COUNT] = {
+	{ SFX_CH_1, SFX_PRIORITY_UI, sfx_start_stop_steps },
+	{ SFX_CH_1, SFX_PRIORITY_UI, sfx_lap_steps },
+	{ SFX_CH_1, SFX_PRIORITY_UI, sfx_reset_steps },
+	{ SFX_CH_1, SFX_PRIORITY_TICK, sfx_tick_steps },
+	{ SFX_CH_2, SFX_PRIORITY_ALARM, sfx_alarm_steps },
+};
+
+//* ------------------------------------------------------------------------------------------- *//
+//* ------------------------------------------  SFX  ------------------------------------------ *//
+//* ------------------------------------------------------------------------------------------- *//
+
+void sound_wake(void) {
+
+	if (!is_sound_on) {
+		SOUND_ON;
+		is_sound_on = TRUE;
+	}
+	sound_tail_frames = SOUND_TAIL_FRAMES;
+
+}
+
+/* ~---------------------------------------------------------------------------
+
+	SOUND QUEUE:
+	Nothing outside this section writes the channel registers. The main loop asks for an effect
+	with sfx_play(), which only queues its id. sound_isr() in the VBL chain starts whatever was
+	queued and then steps every channel once, so the cost per frame is bounded by the queue
+	length plus one step per channel, and no sound write ever lands in the middle of drawing.
+
+	An effect is a list of steps. A step's NRx0 - NRx4 are written as is and then held for some
+	frames, and a step with 0 frames ends the effect. The channel belongs to the effect until
+	then. Another effect only takes it over with the same or a higher priority.
+
+	With TICK_SFX_ISR the timer isr starts the tick itself with sfx_start(). Every start / step
+	in sound_isr() is CRITICAL, so the two never write a channel at the same time.
+
+---------------------------------------------------------------------------~ */
+
+// NOTE: interrupts off
+void sfx_step_write(uint8_t channel, const sfx_step_t *step) {
+
+	sfx_step[channel] = step;
+	sfx_frames[channel] = step->frames;
+	if (!step->frames) return; // done, the envelope rings out on its own
+
+	volatile uint8_t *reg = sfx_channel_regs[channel];
+	for (uint8_t i = 0; i < 5; i++) reg[i] = step->regs[i];
+
+}
+
+// NOTE: interrupts off, from sound_isr() or the timer isr
+void sfx_start(uint8_t id) {
+
+	const sfx_t *sfx = &sfx_table[id];
+	uint8_t channel = sfx->channel;
+
+	if (sfx_frames[channel] && sfx->priority < sfx_priority[channel]) return; // busy with something that matters more
+
+	sfx_priority[channel] = sfx->priority;
+	sfx_step_write(channel, sfx->steps);
+
+}
+
+void sfx_play(uint8_t id) {
+
+	sound_wake();
+
+	uint8_t head = sfx_queue_head;
+	uint8_t next = (head + 1) & (SFX_QUEUE_SIZE - 1);
+	if (next == sfx_queue_tail) return; // four in one frame, the rest can go
+
+	sfx_queue[head] = id;
+	sfx_queue_head = next;
+
+}
+
+//* ------------------------------------------------------------------------------------------- *//
+//* ----------------------------------------  PROFILE  ---------------------------------------- *//
+//* ------------------------------------------------------------------------------------------- *//
+
+#ifdef PROFILE
+
+// NOTE: called with interrupts off, keep it short
+void di_audit_record(uint8_t div_ticks, uint8_t site) {
+
+	if (div_ticks > di_audit_max) {
+		di_audit_max = div_ticks;
+		di_audit_max_site = site;
+		di_audit_dirty = TRUE;
+	}
+
+}
+
+// NOTE: called first thing in the timer isr
+void tick_latency_record(uint8_t tima, uint8_t div) {
+
+	uint8_t latency = (uint8_t)((uint8_t)(tima - TMA_REG) << 2) + (div & 0x03);
+
+	if (latency > tick_latency_max) {
+		tick_latency_max = latency;
+		di_audit_dirty = TRUE;
+	}
+
+}
+
+// NOTE: right after the beep, from the timer isr or the main loop. From the main loop a tick can land
+// between the reads, off by a tick once in a long while
+void tick_sfx_latency_record(void) {
+
+#ifdef TICK_COUNTER_BINARY
+	tick_t ticks = (tick_t)tick_count & TICK_MASK;
+#else
+	tick_t ticks = hundredths;
+#endif
+	uint8_t tima = TIMA_REG;
+	uint8_t div = DIV_REG;
+
+	uint16_t counts = (uint16_t)ticks * (uint8_t)(0x100 - TMA_REG) + (uint8_t)(tima - TMA_REG);
+	uint16_t latency = (counts << 2) + (div & 0x03);
+
+	if (latency > tick_sfx_latency_max) tick_sfx_latency_max = latency;
+	tick_sfx_latency_sum += latency;
+	if (++tick_sfx_latency_beeps == TICK_SFX_REPORT_BEEPS) tick_sfx_report = TRUE;
+
+}
+
+void power_profile_reset(void) {
+
+	power_spins = 0;
+	power_div_wraps = 0;
+
+}
+
+void power_calibrate(void) {
+
+	uint8_t div_now;
+
+	// NOTE: boot only, interrupts are off for a whole DIV_REG roll over (65536 clocks)
+	CRITICAL {
+		// line up on a roll over
+		power_div_prev = DIV_REG;
+		while ((div_now = DIV_REG) >= power_div_prev) power_div_prev = div_now;
+		power_div_prev = div_now;
+
+		// same loop body as wait_for_event()
+		power_profile_reset();
+		while (!power_div_wraps) {
+			div_now = DIV_REG;
+			power_spins++;
+			if (div_now < power_div_prev) power_div_wraps++;
+			power_div_prev = div_now;
+		}
+		power_spins_per_wrap = (uint16_t)power_spins;
+	}
+
+	power_window_wraps = is_cpu_fast ? 7680 : 3840;
+	power_profile_reset();
+
+}
+
+void power_report(void) {
+
+	uint32_t total_clocks = (uint32_t)power_div_wraps << 16;
+	uint32_t idle_clocks = (power_spins / power_spins_per_wrap) << 16;
+	idle_clocks += ((power_spins % power_spins_per_wrap) << 16) / power_spins_per_wrap;
+	if (idle_clocks > total_clocks) idle_clocks = total_clocks; // calibration is +-1 spin
+
+	uint32_t active_clocks = total_clocks - idle_clocks;
+	uint16_t active_permille = (uint16_t)(((active_clocks >> 8) * 1000) / (total_clocks >> 8));
+
+	gotoxy(0, 0);
+	printf("CPU %u.%u%% %s%s ", active_permille / 10, active_permille % 10, stopwatch ? "RUN " : "IDLE", is_lcd_off ? " OFF" : "    ");
+	EMU_printf("cpu active %u.%u%%, %u of %u DIV periods per minute, %s%s", active_permille / 10, active_permille % 10, (uint16_t)(active_clocks >> 16), power_div_wraps, stopwatch ? "running" : "idle", is_lcd_off ? ", lcd off" : "");
+
+	power_profile_reset();
+
+}
+
+void handle_profile(void) {
+
+	if (di_audit_dirty) {
+		di_audit_dirty = FALSE;
+
+		gotoxy(0, 17);
+		printf("DI%u %s%sL%u ", (uint16_t)di_audit_max * 256, di_site_names[di_audit_max_site], (di_audit_max > DI_BUDGET_DIV_TICKS) ? "! " : "  ", (uint16_t)tick_latency_max * 256);
+		EMU_printf("DI max %u clocks @ %s, tick latency max %u clocks", (uint16_t)di_audit_max * 256, di_site_names[di_audit_max_site], (uint16_t)tick_latency_max * 256);
+	}
+
+	if (tick_sfx_report) {
+		uint16_t max;
+		uint16_t avg;
+		CRITICAL {
+			max = tick_sfx_latency_max;
+			avg = (uint16_t)(tick_sfx_latency_sum / TICK_SFX_REPORT_BEEPS);
+			tick_sfx_latency_max = 0;
+			tick_sfx_latency_sum = 0;
+			tick_sfx_latency_beeps = 0;
+			tick_sfx_report = FALSE;
+		}
+		// DIV ticks, 256 clocks each, ~61us in normal speed
+		EMU_printf("tick sfx latency, last %u beeps: max %u avg %u DIV ticks", TICK_SFX_REPORT_BEEPS, max, avg);
+	}
+
+}
+
+#endif
+
+//* ------------------------------------------------------------------------------------------- *//
+//* ----------------------------------------  SYSTEM  ----------------------------------------- *//
+//* ------------------------------------------------------------------------------------------- *//
+
+void set_cpu(void) {
+
+	// NOTE: GBC boots in normal speed, handle_cpu_speed() switches to double speed only when needed
+	if (_cpu == CGB_TYPE) is_gbc = TRUE;
+	if (is_gbc) {
+		set_default_palette(); // palette-0, grayscale
+	}
+
+}
+
+void clear_sprite_tiles(void) {
+
+	for (uint8_t i = 0; i < 127; i++) {
+		set_sprite_data(i, 1, white_tile);
+	}
+
+}
+
+void isr_allow_nesting(void) {
+
+	// NOTE: added first to the VBL, LCD and SIO chains (GBDK's own VBL work still runs before it),
+	// everything after it in those chains can be interrupted, so a timer tick never waits on them.
+	// The timer isr itself is never nested, it always runs start to finish.
+	enable_interrupts();
+
+}
+
+void set_nested_isrs(void) {
+
+	CRITICAL {
+		add_VBL(isr_allow_nesting);
+		add_LCD(isr_allow_nesting);
+		add_SIO(isr_allow_nesting);
+	}
+
+}
+
+void vbl_event_isr(void) {
+
+	vbl_event = TRUE;
+
+}
+
+void joy_event_isr(void) {
+
+#ifdef PROFILE
+	wake_div_start = DIV_REG;
+#endif
+	joy_event = TRUE;
+
+}
+
+// NOTE: with the APU going off, forget whatever was playing
+void sfx_stop_all(void) {
+
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		sfx_queue_tail = sfx_queue_head;
+		for (uint8_t i = 0; i < SFX_CHANNELS; i++) {
+			sfx_frames[i] = 0;
+			sfx_priority[i] = 0;
+		}
+		DI_AUDIT_END(DI_SITE_SOUND);
+	}
+
+}
+
+void sound_isr(void) {
+
+	// NOTE: after isr_allow_nesting(), CRITICAL per channel write keeps the timer isr out of the middle of one
+#ifndef TICK_SFX_ISR
+	if (play_stopwatch_tick_sfx) {
+		play_stopwatch_tick_sfx = FALSE;
+		CRITICAL {
+			DI_AUDIT_BEGIN;
+			sfx_start(SFX_TICK);
+			DI_AUDIT_END(DI_SITE_SOUND);
+		}
+		TICK_SFX_PROBE;
+	}
+#endif
+
+	while (sfx_queue_tail != sfx_queue_head) {
+		CRITICAL {
+			DI_AUDIT_BEGIN;
+			sfx_start(sfx_queue[sfx_queue_tail]);
+			DI_AUDIT_END(DI_SITE_SOUND);
+		}
+		sfx_queue_tail = (sfx_queue_tail + 1) & (SFX_QUEUE_SIZE - 1);
+	}
+
+	for (uint8_t i = 0; i < SFX_CHANNELS; i++) {
+		CRITICAL {
+			DI_AUDIT_BEGIN;
+			if (sfx_frames[i] && --sfx_frames[i] == 0) sfx_step_write(i, sfx_step[i] + 1);
+			DI_AUDIT_END(DI_SITE_SOUND);
+		}
+	}
+
+}
+
+/* ~---------------------------------------------------------------------------
+
+	RASTER:
+	Tile writes that can wait for the display to pass them. At LY == RASTER_LY rows 0 - 12 are done
+	for this frame, so anything queued for them can be written from the STAT (LYC) isr while the
+	rest of the screen draws, it shows whole on the next frame, never half a row. Only the big
+	digits are still written in vblank by the main loop, the split delta and histogram bars (rows
+	7 - 12) go through the queue, in order, so a tile is never written out of turn.
+
+	Capacity, by hand, DMG speed: vblank is 10 lines, ~1140 M-cycles, ~35 per set_vram_byte() from C
+	is ~30 writes at best, with the rest of the frame's work in it the big digits (8) and little
+	else fit. From RASTER_LY to line 143 is 40 lines, set_vram_byte() only writes in hblank (mode 0),
+	~1 write a line, plus whatever runs into vblank: the queue's 31 writes a frame on top, about
+	4x the tiles a frame that vblank alone left for the delta / bars. "raster isr clocks" in
+	PROFILE has the real cost, nothing here was measured.
+
+	The isr runs after isr_allow_nesting(), the timer still cuts in. It ends at the start of an
+	hblank, so a set_vram_byte() it interrupted in the main loop (STAT already checked) still lands
+	outside mode 3.
+
+---------------------------------------------------------------------------~ */
+
+void raster_isr(void) {
+
+	uint8_t head = raster_head;
+	uint8_t tail = raster_tail;
+
+	if (tail == head) return;
+
+	PROFILE_BEGIN("raster isr");
+
+	while (tail != head) {
+		set_vram_byte(raster_addr[tail], raster_tile[tail]);
+		tail = (tail + 1) & (RASTER_QUEUE_SIZE - 1);
+	}
+	raster_tail = tail;
+
+	// NOTE: mode 1 clears STATF_BUSY too, a drain ending in line 143's hblank must not spin through vblank
+	if (LY_REG < 144) {
+		while (!(STAT_REG & STATF_BUSY) && (STAT_REG & 0x03) != 0x01 && LY_REG < 144); // through this hblank
+		while (STAT_REG & STATF_BUSY); // to the start of the next, or vblank
+	}
+
+	PROFILE_END("raster isr clocks: ");
+
+}
+
+// NOTE: rows above RASTER_ROW only, FALSE when full
+bool raster_push(uint8_t *addr, uint8_t tile) {
+
+	uint8_t head = raster_head;
+	uint8_t next = (head + 1) & (RASTER_QUEUE_SIZE - 1);
+
+	if (next == raster_tail) {
+		raster_full = TRUE;
+		return FALSE;
+	}
+
+	raster_addr[head] = addr;
+	raster_tile[head] = tile;
+	raster_head = next; // publish
+
+	return TRUE;
+
+}
+
+// NOTE: on a screen change, whatever is left was for the old screen
+void raster_flush(void) {
+
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		raster_tail = raster_head;
+		DI_AUDIT_END(DI_SITE_RASTER);
+	}
+
+}
+
+void set_event_isrs(void) {
+
+	CRITICAL {
+		add_VBL(vbl_event_isr);
+		add_VBL(sound_isr);
+		add_LCD(raster_isr);
+		add_JOY(joy_event_isr);
+	}
+
+}
+
+void init_system(void) {
+
+	set_cpu();
+
+	clear_sprite_tiles(); // clear VRAM
+	init_bkg(0); // reset bkg_map with tile-0
+
+	// NOTE: the window only ever shows as the bottom overlay (or the lap list bar), placed once here
+	WX_REG = 7;
+	WY_REG = OVERLAY_WIN_Y;
+	HIDE_WIN;
+
+	LYC_REG = RASTER_LY;
+	STAT_REG = STATF_LYC; // the only STAT source, see RASTER
+
+	set_nested_isrs(); // VBL, LCD, SIO can be interrupted by the timer
+	set_event_isrs();
+	power_ie = IE_ACTIVE;
+	set_interrupts(power_ie);
+
+	SHOW_BKG;
+	SHOW_SPRITES;
+
+	sound_wake();
+	DISPLAY_ON;
+
+#ifdef PROFILE
+	power_calibrate();
+#endif
+
+}
+
+//* ------------------------------------------------------------------------------------------- *//
+//* --------------------------------------  INTERRUPTS  --------------------------------------- *//
+//* ------------------------------------------------------------------------------------------- *//
+
+void set_timer_reg_stopwatch(void) {
+
+	// NOTE: no CRITICAL, TMA_REG is a single write so the isr can never see half of it
+	if (!is_cpu_fast) {
+		TMA_REG = (uint8_t)(0x100 - (4096 / TICK_HZ)); // normal speed: divide 4096hz clock down, by 32 at 128hz (4096/32 = 128hz)
+	} else {
+		TMA_REG = (uint8_t)(0x100 - (8192 / TICK_HZ)); // double speed: timer runs at 8192hz, by 64 at 128hz (8192/64 = 128hz)
+	}
+
+}
+
+void set_cpu_speed(bool fast) {
+
+	if (fast == is_cpu_fast) return;
+
+	// NOTE: the switch and the timer fix-up happen in one CRITICAL, so the isr never runs with the
+	// new speed and the old reload value.
+	// cpu_fast() / cpu_slow() clear IF, so everything already pending (tick, vblank, serial, joypad)
+	// is put back afterwards, and the count into the current tick is rescaled (x2 / /2) so the tick
+	// lands when it would have. Progress that reaches a whole period (the last counts of a tick plus
+	// the stall, or TIMA_REG = 0 after a reset) is a tick due now, not a TIMA_REG wrap 256 counts late.
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+
+		uint8_t if_pending = IF_REG;
+		bool running = (TAC_REG & TACF_START);
+		uint16_t tick_progress = (uint8_t)(TIMA_REG - TMA_REG);
+		if (running) tick_progress += CPU_SWITCH_STALL_COUNTS; // a stopped timer doesnt count through the stall
+
+		if (fast) cpu_fast();
+		else cpu_slow();
+		is_cpu_fast = fast;
+
+		set_timer_reg_stopwatch();
+		uint16_t period = 0x100 - TMA_REG;
+		tick_progress = fast ? (tick_progress << 1) : (tick_progress >> 1);
+		if (tick_progress >= period) {
+			tick_progress -= period;
+			if (running) if_pending |= TIM_IFLAG;
+		}
+		TIMA_REG = TMA_REG + (uint8_t)tick_progress;
+		IF_REG |= if_pending;
+
+		DI_AUDIT_END(DI_SITE_CPU_SPEED);
+	}
+
+#ifdef PROFILE
+	power_window_wraps = is_cpu_fast ? 7680 : 3840; // DIV_REG runs at double rate too
+#endif
+	POWER_PROFILE_RESET;
+
+}
+
+// NOTE: from the timer isr, on every whole second in either direction.
+// TRUE when the drift correction wants a tick added / dropped this second
+bool tick_second(void) {
+
+#ifdef TICK_SFX_ISR
+	// NOTE: a handful of register writes, APU is only ever off here while asleep
+	if (is_sound_on) {
+		sfx_start(SFX_TICK);
+		TICK_SFX_PROBE;
+	}
+#else
+	play_stopwatch_tick_sfx = TRUE;
+#endif
+
+	// drift correction, once a second so the other 127 ticks dont pay for it
+	if (!tick_corr_step) return FALSE;
+
+	uint16_t acc = tick_corr_acc + tick_corr_step;
+	bool carry = (acc < tick_corr_acc);
+	tick_corr_acc = acc;
+
+	return carry;
+
+}
+
+// NOTE: from the timer isr, countdown hit zero, right on the tick, not on the next frame
+void countdown_zero(void) {
+
+	TAC_REG = TACF_STOP;
+	stopwatch = FALSE;
+	if (is_sound_on) sfx_start(SFX_ALARM);
+	ALARM_PROBE;
+	alarm_event = TRUE;
+
+}
+
+#ifndef TICK_COUNTER_BINARY
+
+// NOTE: from the timer isr, countdown only, seconds down one with the minutes / hours borrow
+void countdown_borrow(void) {
+
+	// SUB sets N, so DAA corrects for a subtraction:
+	// 0x10 - 0x01 = 0x0F -> 0x09
+	// 0x00 - 0x01 = 0xFF -> 0x99, borrow out
+	__asm__("ld a, (#_seconds)\n sub #0x01\n daa\n ld (#_seconds), a");
+
+	if (seconds == 0x99) {
+		seconds = 0x59;
+		__asm__("ld a, (#_minutes)\n sub #0x01\n daa\n ld (#_minutes), a");
+
+		if (minutes == 0x99) {
+			minutes = 0x59;
+			__asm__("ld a, (#_hours)\n sub #0x01\n daa\n ld (#_hours), a"); // never below 0, zero stops it first
+		}
+	}
+
+}
+
+#endif
+
+/* ~---------------------------------------------------------------------------
+
+	CHANNELS:
+	CHANNEL_COUNT stopwatches on the one TIMA_REG interrupt. Every channel ticks on the same
+	overflow, so a channel started while others run picks up mid tick (up to one tick late),
+	and the drift correction / seconds beep follow a shared second (channel_phase), not any one
+	channel's own.
+
+	channels_step() walks the arrays once per tick, so the isr cost is linear in CHANNEL_COUNT.
+	Counted by hand from the instruction sequence, normal speed, roughly:
+		stopped channel				~20 clocks
+		running, no carry			~60 clocks
+		running, seconds carry		~+60 clocks, 1 tick in TICK_HZ
+		running, minutes carry		~+40 clocks, 1 tick in 60 * TICK_HZ
+	so 4 running channels are ~300 clocks a tick, ~1% of a 128hz tick (32768 clocks).
+	The "timer isr clocks" EMU_PROFILE numbers are the real ones.
+
+---------------------------------------------------------------------------~ */
+
+tick_t channel_phase; // shared tick within the second, drives tick_second() on the channels screen
+
+// NOTE: from the timer isr, BCD + 1, 99 wraps to 00 like the DAA in the stopwatch
+uint8_t bcd_inc(uint8_t bcd) {
+
+	bcd++;
+	if ((bcd & 0x0F) == 0x0A) bcd += 0x06;
+	if (bcd == 0xA0) bcd = 0x00;
+
+	return bcd;
+
+}
+
+// NOTE: from the timer isr, one tick on every running channel
+void channels_step(void) {
+
+	for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+		if (!channel_running[i]) continue;
+
+		tick_t ticks = (channel_ticks[i] + 1) & TICK_MASK;
+		channel_ticks[i] = ticks;
+		if (ticks) continue; // all but 1 in TICK_HZ stop here
+
+		uint8_t s = bcd_inc(channel_seconds[i]);
+		if (s == 0x60) {
+			s = 0x00;
+			channel_minutes[i] = bcd_inc(channel_minutes[i]);
+		}
+		channel_seconds[i] = s;
+	}
+
+}
+
+void stopwatch_timer_isr(void) {
+
+	TICK_LATENCY_PROBE;
+	DI_AUDIT_BEGIN;
+	PROFILE_BEGIN("timer isr");
+
+	if (stopwatch && !tick_hold && channels) {
+		tick_event = TRUE;
+		channels_step();
+		channel_phase = (channel_phase + 1) & TICK_MASK;
+		if (channel_phase == 0 && tick_second()) {
+			if (tick_corr_add) {
+				channels_step(); // one tick on, every running channel
+				tick_corr_net++;
+			} else {
+				tick_hold = TRUE;
+				tick_corr_net--;
+			}
+		}
+	} else if (stopwatch && !tick_hold && countdown) {
+		tick_event = TRUE;
+#ifdef TICK_COUNTER_BINARY
+		if (--tick_count == 0) {
+			countdown_zero();
+		} else if (!((tick_t)tick_count & TICK_MASK) && tick_second()) {
+			if (tick_corr_add) {
+				tick_count--; // one tick on, at least 127 left so never zero here
+				tick_corr_net++;
+			} else {
+				tick_hold = TRUE;
+				tick_corr_net--;
+			}
+		}
+#else
+		if (hundredths) {
+			if (--hundredths == 0) {
+				if (!(seconds | minutes | hours)) {
+					countdown_zero();
+				} else if (tick_second()) {
+					if (tick_corr_add) {
+						hundredths = TICK_HZ - 1; // one tick on, straight into the next second down
+						countdown_borrow();
+						tick_corr_net++;
+					} else {
+						tick_hold = TRUE;
+						tick_corr_net--;
+					}
+				}
+			}
+		} else {
+			hundredths = TICK_HZ - 1;
+			countdown_borrow();
+		}
+#endif
+	} else if (stopwatch && !tick_hold) {
+#ifdef TICK_COUNTER_BINARY
+		tick_count++;
+		tick_event = TRUE;
+		if (!((tick_t)tick_count & TICK_MASK) && tick_second()) {
+			if (tick_corr_add) {
+				tick_count++;
+				tick_corr_net++;
+			} else {
+				tick_hold = TRUE;
+				tick_corr_net--;
+			}
+		}
+#else
+		hundredths = (hundredths + 1) & TICK_MASK;
+		tick_event = TRUE;
+		// If we overflowed
+		if (hundredths == 0) {
+			// GBDK *does* have BCD support, but it's 32bit, *way* overkill, 
+			// so instead I'll just do it in assembly and try to explain...
+			__asm
+				// ; First, we load the value of seconds from its memory address to register A
+				ld a, (#_seconds)
+
+				// ; Now we add 1 to A
+				add #0x01 
+
+				// ; Next, we use the DAA instruction, which based on the CPU flags left by 
+				// ; the previous instruction, corrects the value of A to be a valid BCD value, so for example:
+				// ; 0x00 + 0x01 = 0x01 -> 0x01
+				// ; 0x09 + 0x01 = 0x0A -> 0x10
+				// ; 0x99 + 0x01 = 0x9A -> 0x00
+				daa
+
+				// ; Finally, we write the value of A back to the memory address of seconds
+				ld (#_seconds), a
+			__endasm;
+
+			if (tick_second()) {
+				if (tick_corr_add) {
+					hundredths = 1; // already one tick into the new second
+					tick_corr_net++;
+				} else {
+					tick_hold = TRUE;
+					tick_corr_net--;
+				}
+			}
+
+			if (seconds >= 0x60) {
+				seconds = 0x00;
+				// Need to add 1 to minutes, use same snippet as above but not explained
+				__asm__("ld a, (#_minutes)\n add #0x01\n daa\n ld (#_minutes), a");
+
+				// NOTE: 1 tick in 60 * TICK_HZ gets here, the rest pay nothing for hours
+				if (minutes == 0x60) {
+					minutes = 0x00;
+					__asm__("ld a, (#_hours)\n add #0x01\n daa\n ld (#_hours), a"); // 99:59:59 wraps to 00:00:00
+				}
+			}
+		}
+#endif
+	} else {
+		tick_hold = FALSE; // dropped
+	}
+
+	PROFILE_END("timer isr clocks: ");
+	DI_AUDIT_END(DI_SITE_TIMER_ISR);
+
+}
+
+void set_tick_correction(int16_t ppm) {
+
+	// NOTE: ppm * TICK_HZ / 1000000 ticks a second, in 1/65536ths, worked out here once so the isr
+	// never divides, it just adds the step every second and adds / drops a tick on carry
+	uint16_t abs_ppm = (ppm < 0) ? -ppm : ppm;
+	if (abs_ppm > TICK_CORR_MAX_PPM) abs_ppm = TICK_CORR_MAX_PPM;
+	uint16_t step = (uint16_t)(((uint32_t)abs_ppm * TICK_HZ * 4096) / 62500); // << 16 / 1000000, reduced so it stays in 32 bits
+
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		tick_corr_step = step;
+		tick_corr_add = (ppm < 0);
+		DI_AUDIT_END(DI_SITE_TICK_CORR);
+	}
+
+	tick_corr_ppm = ppm;
+
+}
+
+int16_t ticks_to_ppm(int32_t error_ticks, uint32_t expected_ticks) {
+
+	// NOTE: error_ticks * 1000000 fits 32 bits up to ~2100 ticks, clamped in 32 bits before it
+	// narrows, a short window can come out past anything 16 bits holds
+	if (error_ticks > 2000) error_ticks = 2000;
+	if (error_ticks < -2000) error_ticks = -2000;
+	int32_t ppm = (error_ticks * 1000000) / (int32_t)expected_ticks;
+
+	if (ppm > TICK_CORR_MAX_PPM) ppm = TICK_CORR_MAX_PPM;
+	if (ppm < -TICK_CORR_MAX_PPM) ppm = -TICK_CORR_MAX_PPM;
+
+	return (int16_t)ppm;
+
+}
+
+void set_timer_isr_stopwatch(void) {
+
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		add_TIM(stopwatch_timer_isr); // NOTE: will not be interrupted by other interrupts
+		DI_AUDIT_END(DI_SITE_TIMER_ISR_SET);
+	}
+
+}
+
+void clear_timer_isr_stopwatch(void) {
+
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		remove_TIM(stopwatch_timer_isr);
+		DI_AUDIT_END(DI_SITE_TIMER_ISR_CLEAR);
+	}
+
+}
+
+//* ------------------------------------------------------------------------------------------- *//
+//* -----------------------------------------  TIME  ------------------------------------------ *//
+//* ------------------------------------------------------------------------------------------- *//
+
+uint8_t bcd_to_bin(uint8_t bcd) {
+
+	return (uint8_t)((bcd >> 4) * 10) + (bcd & 0x0F);
+
+}
+
+// NOTE: BCD - 1, never called on 0
+uint8_t bcd_dec(uint8_t bcd) {
+
+	if (!(bcd & 0x0F)) bcd -= 0x06; // 0x10 -> 0x0A -> 0x09
+	return bcd - 1;
+
+}
+
+uint8_t bin_to_bcd(uint8_t bin) {
+
+	return (uint8_t)((bin / 10) << 4) | (bin % 10);
+
+}
+
+uint8_t ticks_to_bcd_hundredths(tick_t ticks) {
+
+	return SubsecondTable[ticks];
+
+}
+
+/* ~---------------------------------------------------------------------------
+
+	COUNTER:
+	Default build, the isr keeps the time as BCD bytes with the DAA carry cascade, drawing is
+	a nibble per digit and only time_to_ticks() does any maths.
+
+	`make COUNTER=binary` (-DTICK_COUNTER_BINARY), the isr keeps one 32 bit tick count instead,
+	so stopwatch_ticks() is a plain read and laps / deltas are a subtract. The digits come from
+	seconds_to_bcd(), a double dabble: the seconds are shifted in from the top bit into the
+	H:MM:SS nibbles, and before each shift a nibble that would reach its radix is bumped so the
+	shift carries it out (+3 from 5 up for the 0-9 digits, +5 from 3 up for the 0-5 tens).
+	No divides, 19 rounds for 99:59:59. print_stopwatch() only runs it when the whole seconds
+	changed, once a second, every other frame is the read and a compare.
+
+	What each costs, estimated, normal speed, build both with `make profile` and compare the
+	"timer isr clocks" / "stopwatch render clocks" EMU_PROFILE numbers for the real ones:
+		isr, 127 ticks in 128		BCD ~40 clocks				binary ~90 clocks (4 byte add)
+		isr, seconds carry			BCD ~+100 clocks			binary ~+60 clocks (tick_second())
+		render, per frame			BCD 6 digit lookups			binary read + compare + 2 lookups
+		render, once a second		-							binary ~2500 clocks of dabble
+	ticks_to_time() uses the same dabble in both builds, it used to divide 32 bits by 60 twice.
+
+---------------------------------------------------------------------------~ */
+
+#define TIME_MAX_SECONDS 359999 // 99:59:59, 19 bits
+
+// NOTE: whole seconds to BCD H:MM:SS, double dabble, see COUNTER
+void seconds_to_bcd(uint32_t total_seconds, stopwatch_time_t *time) {
+
+	if (total_seconds > TIME_MAX_SECONDS) total_seconds = TIME_MAX_SECONDS; // display tops out at 99 hours
+
+	uint8_t h = 0;
+	uint8_t m = 0;
+	uint8_t s = 0;
+	uint8_t bytes[3] = { (uint8_t)(total_seconds >> 16), (uint8_t)(total_seconds >> 8), (uint8_t)total_seconds };
+	uint8_t mask = 0x04; // bit 18, the top one of 19
+
+	for (uint8_t i = 0; i < 3; i++) {
+		uint8_t byte = bytes[i];
+		for (; mask; mask >>= 1) {
+			if ((s & 0x0F) >= 0x05) s += 0x03;
+			if (s >= 0x30) s += 0x50; // tens of seconds, radix 6
+			if ((m & 0x0F) >= 0x05) m += 0x03;
+			if (m >= 0x30) m += 0x50; // tens of minutes, radix 6
+			if ((h & 0x0F) >= 0x05) h += 0x03;
+			if (h >= 0x50) h += 0x30;
+
+			h = (uint8_t)(h << 1) | (m >> 7);
+			m = (uint8_t)(m << 1) | (s >> 7);
+			s = (uint8_t)(s << 1) | ((byte & mask) ? 1 : 0);
+		}
+		mask = 0x80;
+	}
+
+	time->hours = h;
+	time->minutes = m;
+	time->seconds = s;
+
+}
+
+void stopwatch_snapshot(stopwatch_time_t *time) {
+
+#ifdef TICK_COUNTER_BINARY
+	uint32_t ticks;
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		ticks = tick_count;
+		DI_AUDIT_END(DI_SITE_SNAPSHOT);
+	}
+
+	time->ticks = (tick_t)(ticks % TICK_HZ);
+	seconds_to_bcd(ticks / TICK_HZ, time);
+#else
+	// NOTE: the isr can carry between any two of these reads, copy them in one go
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		time->hours = hours;
+		time->minutes = minutes;
+		time->seconds = seconds;
+		time->ticks = hundredths;
+		DI_AUDIT_END(DI_SITE_SNAPSHOT);
+	}
+#endif
+
+}
+
+// NOTE: tick within the second, only ever compared to the last one read
+tick_t stopwatch_phase(void) {
+
+	tick_t phase;
+
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+#ifdef TICK_COUNTER_BINARY
+		phase = (tick_t)tick_count & TICK_MASK;
+#else
+		phase = hundredths;
+#endif
+		DI_AUDIT_END(DI_SITE_SNAPSHOT);
+	}
+
+	return phase;
+
+}
+
+uint32_t time_to_ticks(const stopwatch_time_t *time) {
+
+	uint16_t total_minutes = (uint16_t)bcd_to_bin(time->hours) * 60 + bcd_to_bin(time->minutes);
+	uint32_t total_seconds = (uint32_t)total_minutes * 60 + bcd_to_bin(time->seconds);
+
+	return total_seconds * TICK_HZ + time->ticks;
+
+}
+
+void ticks_to_time(uint32_t ticks, stopwatch_time_t *time) {
+
+	time->ticks = (tick_t)(ticks % TICK_HZ);
+	seconds_to_bcd(ticks / TICK_HZ, time);
+
+}
+
+uint32_t ticks_to_centis(uint32_t ticks) {
+
+	return (ticks / TICK_HZ) * 100 + bcd_to_bin(ticks_to_bcd_hundredths((tick_t)(ticks % TICK_HZ)));
+
+}
+
+// NOTE: first tick that shows those hundredths, ticks_to_centis() gives them back at any TICK_HZ
+uint32_t centis_to_ticks(uint32_t centis) {
+
+	return (centis / 100) * TICK_HZ + ((uint16_t)(centis % 100) * (uint32_t)TICK_HZ + 99) / 100;
+
+}
+
+uint32_t stopwatch_ticks(void) {
+
+#ifdef TICK_COUNTER_BINARY
+	uint32_t ticks;
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		ticks = tick_count;
+		DI_AUDIT_END(DI_SITE_SNAPSHOT);
+	}
+
+	return ticks;
+#else
+	stopwatch_time_t now;
+	stopwatch_snapshot(&now);
+
+	return time_to_ticks(&now);
+#endif
+
+}
+
+void stopwatch_set_ticks(uint32_t ticks) {
+
+#ifdef TICK_COUNTER_BINARY
+	// NOTE: TIMA_REG restarts the tick too, so the new time starts on a whole tick
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		tick_count = ticks;
+		TIMA_REG = TMA_REG;
+		DI_AUDIT_END(DI_SITE_SET_TIME);
+	}
+#else
+	stopwatch_time_t time;
+	ticks_to_time(ticks, &time);
+
+	// NOTE: TIMA_REG restarts the tick too, so the new time starts on a whole tick
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		hours = time.hours;
+		minutes = time.minutes;
+		seconds = time.seconds;
+		hundredths = time.ticks;
+		TIMA_REG = TMA_REG;
+		DI_AUDIT_END(DI_SITE_SET_TIME);
+	}
+#endif
+
+	tick_event = TRUE;
+	split_delta_resync = TRUE; // the time jumped, the delta cant be stepped across it
+
+}
+
+/* ~---------------------------------------------------------------------------
+
+	LAP STATS:
+	Best, worst, mean and standard deviation of this session's laps, updated once per lap from the
+	journal record, never recomputed over the laps. Hundredths, not ticks, so a lap reads the same
+	at any TICK_HZ and the laps read back from the journal at boot go through the same path.
+
+	Mean and variance are Welford's, both kept as running values instead of sums so nothing grows
+	with the lap count: mean += (x - mean) / n and var += ((x - mean_old) * (x - mean_new) - var) / n.
+	The mean carries 8 fraction bits, the deviations are whole hundredths clamped to 0xFFFF (~10 min)
+	so their product fits 32 bits. Two 32 / 16 divides and a 16 x 16 multiply, the same cost for
+	every lap, "lap stats insert clocks" in PROFILE has the real number.
+
+	The square root for the deviation is only taken when the stats screen is drawn.
+
+---------------------------------------------------------------------------~ */
+
+uint32_t journal_record_centis(const journal_record_t *record) {
+
+	return ((uint32_t)((uint16_t)bcd_to_bin(record->minutes) * 60 + bcd_to_bin(record->seconds)) * 100) + bcd_to_bin(record->hundredths);
+
+}
+
+void lap_stats_reset(void) {
+
+	lap_stats_count = 0;
+	lap_stats_mean_q8 = 0;
+	lap_stats_var = 0;
+
+}
+
+uint16_t lap_stats_dev(uint32_t x_q8) {
+
+	uint32_t dev = ((x_q8 > lap_stats_mean_q8) ? x_q8 - lap_stats_mean_q8 : lap_stats_mean_q8 - x_q8) >> 8;
+	return (dev > 0xFFFF) ? 0xFFFF : (uint16_t)dev;
+
+}
+
+void lap_stats_insert(const journal_record_t *record) {
+
+	PROFILE_BEGIN("lap stats insert");
+
+	uint32_t x = journal_record_centis(record);
+	uint32_t x_q8 = x << 8;
+	uint16_t n = ++lap_stats_count;
+
+	if (n == 1) {
+		lap_stats_best = lap_stats_worst = x;
+		lap_stats_best_lap = lap_stats_worst_lap = n;
+		lap_stats_mean_q8 = x_q8;
+		lap_stats_var = 0;
+		PROFILE_END("lap stats insert clocks: ");
+		return;
+	}
+
+	if (x < lap_stats_best) {
+		lap_stats_best = x;
+		lap_stats_best_lap = n;
+	}
+	if (x >= lap_stats_worst) {
+		lap_stats_worst = x;
+		lap_stats_worst_lap = n;
+	}
+
+	uint16_t dev_old = lap_stats_dev(x_q8);
+	if (x_q8 > lap_stats_mean_q8) lap_stats_mean_q8 += (x_q8 - lap_stats_mean_q8) / n;
+	else lap_stats_mean_q8 -= (lap_stats_mean_q8 - x_q8) / n;
+	uint32_t spread = (uint32_t)dev_old * lap_stats_dev(x_q8); // same side of both means, never negative
+
+	if (spread > lap_stats_var) lap_stats_var += (spread - lap_stats_var) / n;
+	else lap_stats_var -= (lap_stats_var - spread) / n;
+
+	PROFILE_END("lap stats insert clocks: ");
+
+}
+
+// NOTE: bit by bit, 16 rounds, floor(sqrt(x))
+uint16_t isqrt32(uint32_t x) {
+
+	uint32_t root = 0;
+	uint32_t bit = 1UL << 30;
+
+	while (bit > x) bit >>= 2;
+	while (bit) {
+		if (x >= root + bit) {
+			x -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return (uint16_t)root;
+
+}
+
+/* ~---------------------------------------------------------------------------
+
+	HISTOGRAM:
+	Lap times bucketed by a fixed width (L/R on the histogram screen), anchored on the session's
+	first lap so the buckets never move under the laps already counted. The first and last
+	bucket also take everything below / above. A lap is one divide and a count++, and marks its
+	bucket dirty, print_histogram() only redraws dirty bars, and of those only the tiles whose
+	fill changed, a bar growing by a lap is one tile. The fills are the 9 histo_bar_tiles, loaded
+	once at boot, nothing is drawn into tile data at runtime.
+
+	Changing the width re-buckets the session from the journal, once, on the button press.
+
+---------------------------------------------------------------------------~ */
+
+uint16_t histo_width_centis(void) {
+
+	return (uint16_t)histo_widths[histo_width_idx] * 100;
+
+}
+
+void histo_reset(void) {
+
+	for (uint8_t i = 0; i < HISTO_BUCKETS; i++) histo_counts[i] = 0;
+	histo_anchored = FALSE;
+	histo_dirty = (1 << HISTO_BUCKETS) - 1;
+
+}
+
+void histo_insert(const journal_record_t *record) {
+
+	uint32_t x = journal_record_centis(record);
+	uint32_t widths = x / histo_width_centis();
+
+	if (!histo_anchored) {
+		histo_anchor = widths;
+		histo_anchored = TRUE;
+	}
+
+	uint8_t bucket;
+	if (widths + HISTO_ANCHOR < histo_anchor) bucket = 0;
+	else if (widths + HISTO_ANCHOR - histo_anchor >= HISTO_BUCKETS) bucket = HISTO_BUCKETS - 1;
+	else bucket = (uint8_t)(widths + HISTO_ANCHOR - histo_anchor);
+
+	if (histo_counts[bucket] != 0xFF) histo_counts[bucket]++;
+	histo_dirty |= 1 << bucket;
+
+}
+
+//* ------------------------------------------------------------------------------------------- *//
+//* -----------------------------------------  SRAM  ------------------------------------------ *//
+//* ------------------------------------------------------------------------------------------- *//
+
+/* ~---------------------------------------------------------------------------
+
+	LAP JOURNAL:
+	Bank SRAM_BANK_JOURNAL is an append-only array of 4 byte records, the next free slot is
+	journal_count. An append writes 4 bytes and nothing else, no table gets rewritten.
+
+	Each record carries a check byte that mixes in the slot index and the journal generation.
+	The check is first written inverted, then the data, then the real check, so a power cut at
+	any point leaves that one slot invalid and everything before it untouched.
+
+	On boot, journal_recover() walks from slot 0 and stops at the first record that does not check,
+	that is the end of the journal. Reset bumps the generation (one byte in bank 0), which makes
+	every old record fail its check, so there is no wipe. Only when the generation wraps
+	(every 256 resets) is the bank invalidated slot by slot.
+
+	All SRAM access happens from the main loop, after drawing, never from an isr.
+	RAM is only enabled while it is being touched, so a power cut can not scribble on it.
+
+---------------------------------------------------------------------------~ */
+
+uint8_t journal_check(const journal_record_t *record, uint16_t idx) {
+
+	return (uint8_t)(record->minutes + record->seconds + record->hundredths + journal_generation + (uint8_t)idx) ^ JOURNAL_CHECK_SALT;
+
+}
+
+// NOTE: RAM enabled, SRAM_BANK_JOURNAL selected
+void journal_invalidate_all(void) {
+
+	for (uint16_t i = 0; i < JOURNAL_CAPACITY; i++) {
+		journal_records[i].check = journal_check((const journal_record_t *)&journal_records[i], i) ^ 0xFF;
+	}
+
+}
+
+// NOTE: RAM enabled, SRAM_BANK_JOURNAL selected
+uint16_t journal_scan(bool stop_at_gap) {
+
+	uint16_t valid = 0;
+
+	for (uint16_t i = 0; i < JOURNAL_CAPACITY; i++) {
+		if (journal_records[i].check == journal_check((const journal_record_t *)&journal_records[i], i)) {
+			valid++;
+		} else if (stop_at_gap) {
+			break;
+		}
+	}
+
+	return valid;
+
+}
+
+uint8_t resume_check(const resume_slot_t *slot) {
+
+	const uint8_t *bytes = (const uint8_t *)slot;
+	uint8_t sum = RESUME_CHECK_SALT;
+
+	for (uint8_t i = 0; i < sizeof(resume_slot_t) - 1; i++) sum += bytes[i];
+
+	return sum;
+
+}
+
+uint8_t split_check(uint8_t count, const volatile uint8_t *bytes) {
+
+	uint8_t sum = count + SPLIT_CHECK_SALT;
+
+	for (uint16_t i = 0; i < (uint16_t)count * sizeof(uint32_t); i++) sum += bytes[i];
+
+	return sum;
+
+}
+
+// NOTE: first thing at boot, before the resume slots or the journal are read
+void sram_format_check(void) {
+
+	ENABLE_RAM;
+
+	SWITCH_RAM(SRAM_BANK_SETTINGS);
+	if (sram_settings.magic[0] != SRAM_MAGIC_0 || sram_settings.magic[1] != SRAM_MAGIC_1) {
+		// first boot on this cart, whatever is in SRAM is noise
+		sram_settings.journal_generation = 0;
+		journal_generation = 0;
+		SWITCH_RAM(SRAM_BANK_JOURNAL);
+		journal_invalidate_all();
+
+		SWITCH_RAM(SRAM_BANK_SETTINGS);
+		sram_settings.cal_ppm = 0;
+		sram_settings.cal_check = CALIBRATE_CHECK_SALT; // calibrate_check(0), valid, no correction
+
+		// noise passes an 8 bit check 1 in 256 per slot, dont boot into a running stopwatch off it
+		for (uint8_t i = 0; i < 2; i++) {
+			resume_slot_t slot;
+			volatile uint8_t *src = (volatile uint8_t *)&sram_settings.resume[i];
+			uint8_t *dst = (uint8_t *)&slot;
+			for (uint8_t j = 0; j < sizeof(resume_slot_t); j++) dst[j] = src[j];
+			src[sizeof(resume_slot_t) - 1] = resume_check(&slot) ^ 0xFF;
+		}
+
+		// same for the split sets, a noise set would show a delta against a run that never was
+		SWITCH_RAM(SRAM_BANK_SPLITS);
+		for (uint8_t i = 0; i < SPLIT_SETS; i++) {
+			volatile split_set_t *set = &split_sets[i];
+			uint8_t count = set->count;
+			if (count > SPLIT_MAX) continue; // split_ref_load() already turns it down
+			set->check = split_check(count, (const volatile uint8_t *)set->splits) ^ 0xFF;
+		}
+
+		SWITCH_RAM(SRAM_BANK_SETTINGS);
+
+		sram_settings.magic[0] = SRAM_MAGIC_0;
+		sram_settings.magic[1] = SRAM_MAGIC_1; // written last, a cut before here formats again
+	}
+
+	DISABLE_RAM;
+
+}
+
+void journal_recover(void) {
+
+	ENABLE_RAM;
+
+	SWITCH_RAM(SRAM_BANK_SETTINGS);
+	journal_generation = sram_settings.journal_generation;
+
+	SWITCH_RAM(SRAM_BANK_JOURNAL);
+
+#ifdef PROFILE
+	uint16_t frames_start = sys_time;
+	PROFILE_BEGIN("journal recover");
+#endif
+	journal_count = journal_scan(TRUE);
+#ifdef PROFILE
+	PROFILE_END("journal recover clocks: ");
+	EMU_printf("journal recover, %u records, %u frames", journal_count, sys_time - frames_start);
+
+	// worst case, every slot in the bank checked, same work per slot as a full journal
+	frames_start = sys_time;
+	PROFILE_BEGIN("journal full bank scan");
+	journal_scan(FALSE);
+	PROFILE_END("journal full bank scan clocks: ");
+	EMU_printf("journal full bank scan, %u slots, %u frames", JOURNAL_CAPACITY, sys_time - frames_start);
+#endif
+
+	DISABLE_RAM;
+
+}
+
+void journal_new_session(void) {
+
+	ENABLE_RAM;
+
+	journal_generation++;
+	if (journal_generation == 0) {
+		// NOTE: wrapped, records from 256 resets ago would check again
+		SWITCH_RAM(SRAM_BANK_JOURNAL);
+		journal_invalidate_all();
+	}
+
+	SWITCH_RAM(SRAM_BANK_SETTINGS);
+	sram_settings.journal_generation = journal_generation; // single byte, the commit
+
+	DISABLE_RAM;
+
+	journal_count = 0;
+
+}
+
+bool journal_append(const journal_record_t *record) {
+
+	if (journal_count >= JOURNAL_CAPACITY) return FALSE; // full, keep what we have
+
+	uint8_t check = journal_check(record, journal_count);
+	volatile journal_record_t *slot = &journal_records[journal_count];
+
+	ENABLE_RAM;
+	SWITCH_RAM(SRAM_BANK_JOURNAL);
+
+	slot->check = check ^ 0xFF; // invalid while the data is half written
+	slot->minutes = record->minutes;
+	slot->seconds = record->seconds;
+	slot->hundredths = record->hundredths;
+	slot->check = check; // commit
+
+	DISABLE_RAM;
+
+	journal_count++;
+	return TRUE;
+
+}
+
+void journal_read(uint16_t idx, journal_record_t *record) {
+
+	ENABLE_RAM;
+	SWITCH_RAM(SRAM_BANK_JOURNAL);
+
+	record->minutes = journal_records[idx].minutes;
+	record->seconds = journal_records[idx].seconds;
+	record->hundredths = journal_records[idx].hundredths;
+
+	DISABLE_RAM;
+
+}
+
+/* ~---------------------------------------------------------------------------
+
+	SPLITS:
+	Bank SRAM_BANK_SPLITS holds SPLIT_SETS reference runs, each the stopwatch time at every split
+	(lap) from the start of the run. On the stopwatch screen, stopped, U/D picks the set and R saves
+	the run just done over it. The times are kept in hundredths, a set saved by one TICK_HZ build
+	reads the same on another, and converted to ticks once per split for the delta.
+	Same commit order as the journal: check inverted, data, real check, a set that doesnt check is
+	treated as empty. On a fresh cart sram_format_check() spoils every set's check, like the
+	resume slots, so noise that happens to check isnt taken for a run.
+
+	While running, SPLIT_ROW shows now - reference for the split being run. It is only worked out
+	in full when that changes (start of a split, set change, the time jumping, wake), every other
+	frame it is stepped by the ticks since the last frame, a BCD add / subtract with a carry at
+	most, no multiply or divide.
+
+	The time is drawn in vblank, the delta goes through the RASTER queue, a digit that doesnt fit
+	stays dirty and goes next frame.
+
+---------------------------------------------------------------------------~ */
+
+void split_ref_load(void) {
+
+	volatile split_set_t *set = &split_sets[split_set];
+
+	ENABLE_RAM;
+	SWITCH_RAM(SRAM_BANK_SPLITS);
+
+	uint8_t count = set->count;
+	bool valid = (count <= SPLIT_MAX) && (set->check == split_check(count, (const volatile uint8_t *)set->splits));
+
+	DISABLE_RAM;
+
+	split_ref_count = valid ? count : 0;
+
+}
+
+void split_save(void) {
+
+	volatile split_set_t *set = &split_sets[split_set];
+	volatile uint8_t *dst = (volatile uint8_t *)set->splits;
+	const uint8_t *src = (const uint8_t *)run_splits;
+	uint8_t count = run_split_count;
+	uint8_t check = split_check(count, src);
+
+	ENABLE_RAM;
+	SWITCH_RAM(SRAM_BANK_SPLITS);
+
+	set->check = check ^ 0xFF; // invalid while half written
+	set->count = count;
+	for (uint16_t i = 0; i < (uint16_t)count * sizeof(uint32_t); i++) dst[i] = src[i];
+	set->check = check; // commit
+
+	DISABLE_RAM;
+
+	split_ref_count = count;
+
+}
+
+// NOTE: reference for the split being run, only while this run's laps line up with it
+void split_ref_next_load(void) {
+
+	split_delta_on = (run_split_count == lap_count && run_split_count < split_ref_count);
+
+	if (split_delta_on) {
+		ENABLE_RAM;
+		SWITCH_RAM(SRAM_BANK_SPLITS);
+		uint32_t centis = split_sets[split_set].splits[run_split_count];
+		DISABLE_RAM;
+		split_ref_next = centis_to_ticks(centis); // the delta is worked in ticks, once per split
+	}
+
+	split_delta_resync = TRUE;
+	tick_event = TRUE; // drawn on the next vblank
+
+}
+
+/* ~---------------------------------------------------------------------------
+
+	CALIBRATE:
+	The user times a known interval against a reference clock on the calibrate screen, the
+	correction is switched off there so the stopwatch counts the raw crystal. The error over the
+	interval gives the ppm, kept in SRAM bank 0 and handed to set_tick_correction() at boot.
+
+	Nothing new in the isr, it is the same once a second accumulator the RTC drift check uses
+	(one 16 bit add per second, a tick added / dropped on carry), so the per tick cost is the
+	tick_hold test that was already there. Reaction time is ~+-50ms at each end, a long target
+	is what gets it down to tens of ppm (10 minutes ~+-170ppm, 60 minutes ~+-30ppm).
+
+	RTC builds: the RTC drift check measures the crystal itself and takes over once it has a
+	window, the calibration is what runs until then.
+
+---------------------------------------------------------------------------~ */
+
+uint8_t calibrate_check(int16_t ppm) {
+
+	return ((uint8_t)ppm + (uint8_t)((uint16_t)ppm >> 8)) ^ CALIBRATE_CHECK_SALT;
+
+}
+
+void calibrate_load(void) {
+
+	ENABLE_RAM;
+	SWITCH_RAM(SRAM_BANK_SETTINGS);
+
+	int16_t ppm = sram_settings.cal_ppm;
+	bool valid = (sram_settings.cal_check == calibrate_check(ppm));
+
+	DISABLE_RAM;
+
+	cal_ppm = valid ? ppm : 0; // cut mid save, run uncorrected rather than on half a value
+	set_tick_correction(cal_ppm);
+
+}
+
+void calibrate_save(int16_t ppm) {
+
+	ENABLE_RAM;
+	SWITCH_RAM(SRAM_BANK_SETTINGS);
+
+	sram_settings.cal_check = calibrate_check(ppm) ^ 0xFF; // invalid while half written
+	sram_settings.cal_ppm = ppm;
+	sram_settings.cal_check = calibrate_check(ppm); // commit
+
+	DISABLE_RAM;
+
+	cal_ppm = ppm;
+
+}
+
+//* ------------------------------------------------------------------------------------------- *//
+//* ------------------------------------------  RTC  ------------------------------------------ *//
+//* ------------------------------------------------------------------------------------------- *//
+
+/* ~---------------------------------------------------------------------------
+
+	`make rtc` only (MBC3 + TIMER cart).
+
+	The timer runs off the CPU crystal, the RTC off its own 32768hz one. While running, the RTC
+	seconds register is polled every vblank, the moment it changes the stopwatch is sampled,
+	so both ends of a window are lined up on an RTC second to within a frame.
+
+	Every RTC_CHECK_SECONDS (once the window is RTC_MIN_WINDOW_SECONDS long) the raw crystal ticks
+	(stopwatch ticks minus what the correction added / dropped) are compared to RTC seconds * TICK_HZ,
+	and the difference in ppm becomes the new correction. The window only grows, so the estimate
+	keeps getting better, until RTC_MAX_WINDOW_SECONDS where it starts again from that second.
+
+	Pausing closes the window (the timer stops, the RTC doesnt), starting opens a new one.
+
+---------------------------------------------------------------------------~ */
+
+#ifdef USE_RTC
+
+uint8_t rtc_read_reg(uint8_t reg) {
+
+	SWITCH_RAM(reg);
+	return *(volatile uint8_t *)SRAM_ADDR;
+
+}
+
+void rtc_latch(void) {
+
+	RTC_LATCH_REG = 0x00;
+	RTC_LATCH_REG = 0x01;
+
+}
+
+void rtc_init(void) {
+
+	ENABLE_RAM;
+
+	rtc_latch();
+	uint8_t dh = rtc_read_reg(RTC_REG_DH);
+	if (dh & RTC_DH_HALT) *(volatile uint8_t *)SRAM_ADDR = dh & ~RTC_DH_HALT; // fresh cart, start the clock
+
+	DISABLE_RAM;
+
+	rtc_prev_second = RTC_NO_SECOND;
+
+}
+
+uint8_t rtc_poll_second(void) {
+
+	ENABLE_RAM;
+	rtc_latch();
+	uint8_t second = rtc_read_reg(RTC_REG_S);
+	DISABLE_RAM;
+
+	return second;
+
+}
+
+uint32_t rtc_read_seconds(void) {
+
+	ENABLE_RAM;
+
+	rtc_latch();
+	uint8_t s = rtc_read_reg(RTC_REG_S);
+	uint8_t m = rtc_read_reg(RTC_REG_M);
+	uint8_t h = rtc_read_reg(RTC_REG_H);
+	uint16_t days = ((uint16_t)(rtc_read_reg(RTC_REG_DH) & 0x01) << 8) | rtc_read_reg(RTC_REG_DL);
+
+	DISABLE_RAM;
+
+	return (((uint32_t)days * 24 + h) * 60 + m) * 60 + s;
+
+}
+
+void rtc_window_reset(void) {
+
+	rtc_window_open = FALSE;
+	rtc_prev_second = RTC_NO_SECOND; // next change seen is a real edge
+
+}
+
+void print_drift(void) {
+
+	gotoxy(1, 11);
+	printf("DRIFT %dPPM    ", tick_corr_ppm);
+
+}
+
+void rtc_check(void) {
+
+	uint32_t rtc_seconds = rtc_read_seconds();
+
+	stopwatch_time_t now;
+	stopwatch_snapshot(&now);
+	uint32_t ticks = time_to_ticks(&now);
+
+	int16_t corr_net;
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		corr_net = tick_corr_net;
+		DI_AUDIT_END(DI_SITE_TICK_CORR);
+	}
+
+	uint32_t window_seconds = rtc_seconds - rtc_ref_seconds;
+
+	if (!rtc_window_open || ticks < rtc_ref_ticks || window_seconds >= RTC_MAX_WINDOW_SECONDS) {
+		// first edge after start, or the window has run its course, start measuring from here
+		rtc_window_open = TRUE;
+		rtc_ref_seconds = rtc_seconds;
+		rtc_ref_ticks = ticks;
+		rtc_ref_corr_net = corr_net;
+		return;
+	}
+
+	if (window_seconds < RTC_MIN_WINDOW_SECONDS || (window_seconds % RTC_CHECK_SECONDS)) return;
+
+	int32_t raw_ticks = (int32_t)(ticks - rtc_ref_ticks) - (corr_net - rtc_ref_corr_net);
+	int32_t expected_ticks = (int32_t)window_seconds * TICK_HZ;
+	int32_t error_ticks = raw_ticks - expected_ticks;
+
+	int16_t ppm = ticks_to_ppm(error_ticks, expected_ticks);
+
+#ifdef PROFILE
+	EMU_printf("rtc %u s, raw %d ticks off, %d ppm", (uint16_t)window_seconds, (int16_t)error_ticks, ppm);
+#endif
+
+	if (ppm != tick_corr_ppm) {
+		set_tick_correction(ppm);
+		print_drift();
+	}
+
+}
+
+/* ~---------------------------------------------------------------------------
+
+	RESUME:
+	Start, lap, pause and reset save the stopwatch state to SRAM: running or not, the stopwatch
+	time at a reference point and the RTC seconds at that point. After a start the reference is
+	moved onto the next RTC edge, so it is exact to a frame.
+
+	On boot, resume_stopwatch() rebuilds the time as ref_ticks + RTC seconds since the reference,
+	before anything slow (journal scan) runs, so the resumed time is up within a frame or two.
+	The sub-second part is unknown at that point, it starts on a half second guess and gets fixed
+	on the next RTC edge (within a second).
+
+---------------------------------------------------------------------------~ */
+
+void resume_save(void) {
+
+	resume_slot_t slot;
+	slot.seq = ++resume_seq;
+	slot.running = resume_running;
+	slot.ref_rtc_seconds = resume_ref_rtc_seconds;
+	slot.ref_ticks = resume_ref_ticks;
+	slot.lap_split_ticks = lap_split_ticks;
+	slot.check = resume_check(&slot);
+
+	resume_slot_idx ^= 1; // overwrite the older one
+	volatile uint8_t *dst = (volatile uint8_t *)&sram_settings.resume[resume_slot_idx];
+	const uint8_t *src = (const uint8_t *)&slot;
+
+	ENABLE_RAM;
+	SWITCH_RAM(SRAM_BANK_SETTINGS);
+
+	dst[sizeof(resume_slot_t) - 1] = slot.check ^ 0xFF; // invalid while half written
+	for (uint8_t i = 0; i < sizeof(resume_slot_t) - 1; i++) dst[i] = src[i];
+	dst[sizeof(resume_slot_t) - 1] = slot.check; // commit
+
+	DISABLE_RAM;
+
+}
+
+bool resume_load(resume_slot_t *slot) {
+
+	resume_slot_t slots[2];
+	bool valid[2];
+
+	ENABLE_RAM;
+	SWITCH_RAM(SRAM_BANK_SETTINGS);
+
+	for (uint8_t i = 0; i < 2; i++) {
+		volatile uint8_t *src = (volatile uint8_t *)&sram_settings.resume[i];
+		uint8_t *dst = (uint8_t *)&slots[i];
+		for (uint8_t j = 0; j < sizeof(resume_slot_t); j++) dst[j] = src[j];
+		valid[i] = (slots[i].check == resume_check(&slots[i]));
+	}
+
+	DISABLE_RAM;
+
+	if (!valid[0] && !valid[1]) return FALSE;
+
+	// newest valid one, seq wraps so compare by difference
+	uint8_t newest = (!valid[1] || (valid[0] && (int8_t)(slots[0].seq - slots[1].seq) > 0)) ? 0 : 1;
+
+	*slot = slots[newest];
+	resume_slot_idx = newest;
+	resume_seq = slot->seq;
+
+	return TRUE;
+
+}
+
+void resume_mark_start(void) {
+
+	resume_running = TRUE;
+	resume_ref_rtc_seconds = rtc_read_seconds();
+	resume_ref_ticks = stopwatch_ticks();
+	resume_save(); // good to a second, until the next edge
+
+	resume_ref_pending = TRUE;
+
+}
+
+void resume_mark_stop(uint32_t ticks) {
+
+	resume_running = FALSE;
+	resume_ref_ticks = ticks;
+	resume_ref_pending = FALSE;
+	resume_align_pending = FALSE;
+	resume_save();
+
+}
+
+void resume_on_edge(void) {
+
+	if (resume_align_pending) {
+		// NOTE: first edge after a boot resume, the time since the reference is now exact
+		resume_align_pending = FALSE;
+		uint32_t rtc_seconds = rtc_read_seconds();
+		uint32_t ticks = resume_ref_ticks + (rtc_seconds - resume_ref_rtc_seconds) * TICK_HZ;
+		stopwatch_set_ticks(ticks);
+		rtc_window_reset(); // the time jumped, start measuring drift from here
+
+		resume_ref_rtc_seconds = rtc_seconds;
+		resume_ref_ticks = ticks;
+		resume_save();
+	} else if (resume_ref_pending) {
+		resume_ref_pending = FALSE;
+		resume_ref_rtc_seconds = rtc_read_seconds();
+		resume_ref_ticks = stopwatch_ticks();
+		resume_save();
+	}
+
+}
+
+void handle_rtc(void) {
+
+	if (!stopwatch) return;
+
+	uint8_t second = rtc_poll_second();
+	if (second == rtc_prev_second) return;
+
+	bool edge = (rtc_prev_second != RTC_NO_SECOND);
+	rtc_prev_second = second;
+	if (edge) {
+		resume_on_edge();
+		rtc_check();
+	}
+
+}
+
+#endif
+
+//* ------------------------------------------------------------------------------------------- *//
+//* -----------------------------------------  LINK  ------------------------------------------ *//
+//* ------------------------------------------------------------------------------------------- *//
+
+/* ~---------------------------------------------------------------------------
+
+	Synced start / stop over the link cable, set up on the link screen.
+
+	The master clocks one command byte out (SC_REG internal clock), the slave sits armed on the
+	external clock. The transfer completes on the same clock edge at both ends, so both SIO isrs
+	fire together and both act on the command right there: DIV_REG and TIMA_REG are reset on start
+	so the 4096hz phase and the tick are lined up too, not just the time. The master never starts
+	on the button press, only on its own transfer complete, that is what keeps the two together.
+	Skew is the interrupt entry on each end, a few us, unless one end is inside a CRITICAL block,
+	then up to the DI budget (see PROFILE notes).
+
+	link_isr() goes ahead of isr_allow_nesting() in the SIO chain, a timer tick cant land between
+	the transfer and the latch. Resetting DIV_REG throws off any PROFILE window open across it,
+	start resets the power window anyway.
+
+	A link cable is point to point, one master and one slave.
+	Commands are only acted on from the stopwatch screen, the slave still answers pings anywhere.
+	Each command ends with the same handler the buttons use, see handle_link().
+
+-------------------------------------------------------------------------------
+
+	TELEMETRY:
+	Same port, the Game Boy drives the clock (8192hz, ~1KB/s) and a host on the other end just
+	listens. Frames are queued whole into telemetry_ring from the main loop, the SIO isr sends the
+	next byte each time one finishes, so nothing ever waits on the wire. A frame that doesnt fit
+	is dropped and counted, never half queued.
+
+	frame: SOF (0xA5) | type | length | payload ... | check
+	check is ~(type + length + payload), 8 bit. A snapshot goes out once a second while running,
+	start / stop / reset / lap as they happen. tools/telemetry_rx.py decodes it on the host.
+
+---------------------------------------------------------------------------~ */
+
+void telemetry_tx_next(void) {
+
+	// NOTE: from the SIO isr, or the main loop inside CRITICAL to get it going
+	if (telemetry_tail == telemetry_head) {
+		telemetry_tx_busy = FALSE;
+		return;
+	}
+
+	telemetry_tx_busy = TRUE;
+	SB_REG = telemetry_ring[telemetry_tail];
+	telemetry_tail = (telemetry_tail + 1) & (TELEMETRY_RING_SIZE - 1);
+	SC_REG = SIOF_XFER_START | SIOF_CLOCK_INT;
+
+}
+
+void link_isr(void) {
+
+	uint8_t cmd;
+
+	if (link_mode == LINK_TELEMETRY) {
+		telemetry_tx_next();
+		return;
+	} else if (link_mode == LINK_MASTER) {
+		cmd = link_tx_cmd;
+		link_peer = (SB_REG == LINK_ACK);
+	} else if (link_mode == LINK_SLAVE) {
+		cmd = SB_REG;
+		SB_REG = LINK_ACK;
+		SC_REG = SIOF_XFER_START | SIOF_CLOCK_EXT; // re-arm for the next one
+		if (screen != SCREEN_STOPWATCH && cmd != LINK_CMD_PING) return;
+	} else {
+		return;
+	}
+
+	if (cmd == LINK_CMD_START) {
+		DIV_REG = 0; // may bump TIMA_REG, overwritten next
+		TIMA_REG = TMA_REG; // whole tick from here
+		TAC_REG = TACF_4KHZ | TACF_START;
+		stopwatch = TRUE;
+	} else if (cmd == LINK_CMD_STOP) {
+		TAC_REG = TACF_STOP;
+		stopwatch = FALSE;
+	} else if (cmd != LINK_CMD_RESET && cmd != LINK_CMD_PING) {
+		return; // noise, or nobody on the other end
+	}
+
+	link_rx_cmd = cmd;
+	link_event = TRUE;
+
+}
+
+void set_link_isr(void) {
+
+	// NOTE: ahead of isr_allow_nesting(), so it runs with interrupts still off
+	CRITICAL {
+		remove_SIO(isr_allow_nesting);
+		add_SIO(link_isr);
+		add_SIO(isr_allow_nesting);
+	}
+
+}
+
+void set_link_mode(uint8_t mode) {
+
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		link_mode = mode;
+		link_peer = FALSE;
+		link_rx_cmd = 0;
+		telemetry_head = telemetry_tail = 0;
+		telemetry_tx_busy = FALSE;
+		if (mode == LINK_SLAVE) {
+			SB_REG = LINK_ACK;
+			SC_REG = SIOF_XFER_START | SIOF_CLOCK_EXT;
+		} else {
+			SC_REG = SIOF_CLOCK_EXT; // drop anything in flight
+		}
+		DI_AUDIT_END(DI_SITE_LINK_MODE);
+	}
+
+}
+
+bool link_send(uint8_t cmd) {
+
+	// NOTE: ~1ms a byte, a press in the middle of one is dropped
+	if (link_mode != LINK_MASTER || (SC_REG & SIOF_XFER_START)) return FALSE;
+
+	link_tx_cmd = cmd;
+	SB_REG = cmd;
+	SC_REG = SIOF_XFER_START | SIOF_CLOCK_INT;
+
+	return TRUE;
+
+}
+
+void telemetry_send(uint8_t type, const uint8_t *payload, uint8_t len) {
+
+	if (link_mode != LINK_TELEMETRY) return;
+
+	uint8_t head = telemetry_head;
+	uint8_t room = (telemetry_tail - head - 1) & (TELEMETRY_RING_SIZE - 1);
+	if (room < len + TELEMETRY_FRAME_OVERHEAD) {
+		if (telemetry_dropped != 0xFF) telemetry_dropped++;
+		return;
+	}
+
+	uint8_t check = type + len;
+	telemetry_ring[head] = TELEMETRY_SOF; head = (head + 1) & (TELEMETRY_RING_SIZE - 1);
+	telemetry_ring[head] = type; head = (head + 1) & (TELEMETRY_RING_SIZE - 1);
+	telemetry_ring[head] = len; head = (head + 1) & (TELEMETRY_RING_SIZE - 1);
+	for (uint8_t i = 0; i < len; i++) {
+		check += payload[i];
+		telemetry_ring[head] = payload[i]; head = (head + 1) & (TELEMETRY_RING_SIZE - 1);
+	}
+	telemetry_ring[head] = ~check; head = (head + 1) & (TELEMETRY_RING_SIZE - 1);
+
+	telemetry_head = head; // the whole frame at once
+
+	// NOTE: telemetry_tx_next() runs in here too, kick off the first byte, counted in the audit
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		if (!telemetry_tx_busy) telemetry_tx_next();
+		DI_AUDIT_END(DI_SITE_TELEMETRY);
+	}
+
+}
+
+void telemetry_event(uint8_t event) {
+
+	stopwatch_time_t now;
+	stopwatch_snapshot(&now);
+
+	uint8_t payload[5] = { event, now.minutes, now.seconds, TELEMETRY_TICKS(now.ticks), now.hours };
+	telemetry_send(TELEMETRY_EVENT, payload, sizeof(payload));
+
+}
+
+//* ------------------------------------------------------------------------------------------- *//
+//* -----------------------------------------  INITS  ----------------------------------------- *//
+//* ------------------------------------------------------------------------------------------- *//
+
+// NOTE: any map, no console, for rows printf cant reach (the window, bkg rows past 17)
+void print_tiles(uint8_t *xy_addr, const char *text) {
+
+	while (*text) set_vram_byte(xy_addr++, numbers_base_tile_idx + (*text++ - '0'));
+
+}
+
+/* ~---------------------------------------------------------------------------
+
+	OVERLAY:
+	The controls at the bottom change with start / stop ("A: Start" / "A: Stop", "B: Reset" /
+	"B: Lap"). Each scene prints the stopped ones on the bkg and the running ones on the window,
+	once when the screen is entered, and start / stop only shows or hides the window, one LCDC bit
+	instead of ~20 tiles of printf on every press.
+
+	The window runs from WY_REG to the bottom of the screen, so only the bottom block can go on it,
+	the header stays on the bkg (its static anyway). It also covers row 17, the PROFILE DI line
+	only shows while stopped (the max is latched, nothing is lost).
+
+---------------------------------------------------------------------------~ */
+
+// NOTE: NULL leaves the row empty
+void init_overlay(const char *a_label, const char *b_label, const char *st_label) {
+
+	for (uint8_t y = 0; y < OVERLAY_ROWS; y++) print_tiles(get_win_xy_addr(0, y), "                    ");
+
+	print_tiles(get_win_xy_addr(1, 0), "------------------");
+	if (a_label) {
+		print_tiles(get_win_xy_addr(5, 1), "A:   ");
+		print_tiles(get_win_xy_addr(10, 1), a_label);
+	}
+	if (b_label) {
+		print_tiles(get_win_xy_addr(5, 2), "B:   ");
+		print_tiles(get_win_xy_addr(10, 2), b_label);
+	}
+	if (st_label) {
+		print_tiles(get_win_xy_addr(5, 3), "ST:  ");
+		print_tiles(get_win_xy_addr(10, 3), st_label);
+	}
+
+	overlay_on = TRUE;
+
+}
+
+void overlay_show(void) {
+
+	if (!overlay_on) return;
+
+	if (stopwatch) SHOW_WIN;
+	else HIDE_WIN;
+
+}
+
+void init_header(const char *title) {
+
+	gotoxy(1, 1);
+	printf("%s", title);
+	gotoxy(16, 1);
+	printf("%u/%u", screen + 1, SCREEN_COUNT); // page, SELECT for the next one
+	gotoxy(1, 2);
+	printf("------------------");
+
+	gotoxy(6, 6);
+	printf("00:00:00");
+	stopwatch_xy_addr = get_bkg_xy_addr(6, 6);
+	for (uint8_t i = 0; i < 8; i++) stopwatch_tiles[i] = numbers_base_tile_idx; // colons are never compared
+
+	gotoxy(1, 13);
+	printf("------------------");
+
+}
+
+void init_scene(void) {
+
+	init_header("GB STOPWATCH :");
+
+	gotoxy(5, 12);
+	printf("R:   Save Ref");
+
+	gotoxy(5, 14);
+	printf("A:   Start");
+	gotoxy(5, 15);
+	printf("B:   Reset");
+	gotoxy(5, 16);
+	printf("ST:  Sleep");
+
+	init_overlay("Stop", "Lap", "Sleep");
+
+}
+
+void init_channels_scene(void) {
+
+	init_header("CHANNELS :");
+
+	for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+		gotoxy(2, CHANNEL_ROW(i));
+		printf("%u", i + 1);
+		gotoxy(6, CHANNEL_ROW(i));
+		printf("00:00:00");
+		for (uint8_t j = 0; j < 8; j++) channel_tiles[i][j] = numbers_base_tile_idx;
+	}
+
+	gotoxy(1, 12);
+	printf("U/D CHANNEL");
+
+	gotoxy(5, 14);
+	printf("A:   Start/Stop");
+	gotoxy(5, 15);
+	printf("B:   Reset");
+	gotoxy(5, 16);
+	printf("ST:  Sleep");
+
+}
+
+void init_calibrate_scene(void) {
+
+	init_header("CALIBRATE :");
+
+	gotoxy(5, 14);
+	printf("A:   Start");
+	gotoxy(5, 15);
+	printf("B:   Reset");
+	gotoxy(5, 16);
+	printf("ST:  Save");
+
+	init_overlay("Stop", "Reset", "Save");
+
+}
+
+void init_link_scene(void) {
+
+	init_header("LINK :");
+
+	gotoxy(5, 14);
+	printf("A:   Ping");
+
+}
+
+void init_laps_scene(void) {
+
+	// NOTE: the bkg is the lap ring, title, time and controls sit on the window below it
+	print_tiles(get_win_xy_addr(0, 0), "                    ");
+	print_tiles(get_win_xy_addr(0, 1), "                    ");
+	print_tiles(get_win_xy_addr(1, 0), "LAPS");
+	char page[] = "0/0";
+	page[0] += screen + 1;
+	page[2] += SCREEN_COUNT;
+	print_tiles(get_win_xy_addr(16, 0), page);
+	print_tiles(get_win_xy_addr(6, 0), "00:00:00");
+	stopwatch_xy_addr = get_win_xy_addr(6, 0);
+	for (uint8_t i = 0; i < 8; i++) stopwatch_tiles[i] = numbers_base_tile_idx;
+	// NOTE: one line for both states, the window always shows from its map row 0, there is no
+	// second copy to flip to, and start / stop then never touch it (like the channels screen)
+	print_tiles(get_win_xy_addr(1, 1), "A:Start/Stop  B:Lap");
+
+	WY_REG = LAPLIST_WIN_Y;
+	SHOW_WIN;
+
+}
+
+void init_stats_scene(void) {
+
+	init_header("LAP STATS :");
+
+}
+
+void init_histogram_scene(void) {
+
+	init_header("LAP HISTOGRAM :");
+
+	gotoxy(5, 14);
+	printf("L/R: Width");
+
+}
+
+void init_countdown_scene(void) {
+
+	init_header("COUNTDOWN :");
+
+	gotoxy(5, 14);
+	printf("A:   Start");
+	gotoxy(5, 15);
+	printf("B:   Reset");
+	gotoxy(5, 16);
+	printf("ST:  Sleep");
+
+	init_overlay("Stop", NULL, "Sleep"); // B does nothing while running
+
+}
+
+//* ------------------------------------------------------------------------------------------- *//
+//* ---------------------------------------  ROUTINES  ---------------------------------------- *//
+//* ------------------------------------------------------------------------------------------- *//
+
+void reset_stopwatch(void) {
+
+	sfx_play(SFX_RESET);
+
+	TIMA_REG = 0; // reset TIMA_REG
+	stopwatch = FALSE; // saftey, should already be false
+
+#ifdef TICK_COUNTER_BINARY
+	tick_count = 0;
+#else
+	hours = 0;
+	minutes = 0;
+	seconds = 0;
+	hundredths = 0;
+#endif
+
+	tick_event = TRUE; // redraw on next vblank, only the digits that were not already 0
+	telemetry_event(TELEMETRY_EVENT_RESET);
+
+	lap_count = 0;
+	lap_split_ticks = 0;
+	lap_pending = FALSE;
+	journal_new_session();
+	lap_stats_reset();
+	histo_reset();
+
+	run_split_count = 0;
+	split_ref_next_load();
+
+#ifdef USE_RTC
+	resume_mark_stop(0);
+#endif
+
+	gotoxy(1, 9);
+	printf("                  "); // clear lap
+
+}
+
+void stopwatch_paused(void) {
+
+	// NOTE: everything after the timer stopped, shared with a stop over the link
+	POWER_PROFILE_RESET;
+	telemetry_event(TELEMETRY_EVENT_STOP);
+#ifdef USE_RTC
+	rtc_window_reset(); // the RTC keeps going, the timer doesnt
+	if (screen == SCREEN_STOPWATCH || screen == SCREEN_LAPS) resume_mark_stop(stopwatch_ticks()); // calibration runs are not resumed
+#endif
+
+	sfx_play(SFX_START_STOP);
+
+	overlay_show();
+
+}
+
+void pause_stopwatch(void) {
+
+	// NOTE: dont reset TIMA_REG, pick up where it left off
+
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		TAC_REG = TACF_STOP; // stop timer
+		stopwatch = FALSE;
+		DI_AUDIT_END(DI_SITE_PAUSE);
+	}
+
+	stopwatch_paused();
+
+}
+
+void stopwatch_started(void) {
+
+	// NOTE: everything after the timer started, shared with a start over the link
+	POWER_PROFILE_RESET;
+	telemetry_event(TELEMETRY_EVENT_START);
+#ifdef USE_RTC
+	rtc_window_reset();
+	if ((screen == SCREEN_STOPWATCH || screen == SCREEN_LAPS) && !resume_align_pending) resume_mark_start(); // resumed at boot, keep the saved reference
+#endif
+
+	sfx_play(SFX_START_STOP);
+
+	overlay_show(); // no laps while calibrating, its overlay says so
+
+}
+
+void start_stopwatch(void) {
+
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		TAC_REG = TACF_4KHZ | TACF_START; // start timer
+		stopwatch = TRUE;
+		DI_AUDIT_END(DI_SITE_START);
+	}
+
+	stopwatch_started();
+
+}
+
+inline void set_stopwatch_tile(uint8_t *starting_bkg_xy_addr, uint8_t idx, uint8_t tile) {
+
+	if (stopwatch_tiles[idx] != tile) {
+		stopwatch_tiles[idx] = tile;
+		set_vram_byte((starting_bkg_xy_addr + idx), tile);
+	}
+
+}
+
+inline void print_stopwatch(void) {
+
+	// BCD2Text is... weird, so we'll do it ourselves, cheaper than casting probs
+
+	uint8_t *starting_bkg_xy_addr = stopwatch_xy_addr;
+
+#ifdef TICK_COUNTER_BINARY
+	// NOTE: same names as the isr bytes in the BCD build, so the drawing below is shared
+	uint32_t ticks;
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		ticks = tick_count;
+		DI_AUDIT_END(DI_SITE_SNAPSHOT);
+	}
+
+	uint32_t total_seconds = ticks / TICK_HZ;
+	if (total_seconds != render_seconds) {
+		render_seconds = total_seconds;
+		seconds_to_bcd(total_seconds, &render_time); // once a second
+	}
+
+	uint8_t hours = render_time.hours;
+	uint8_t minutes = render_time.minutes;
+	uint8_t seconds = render_time.seconds;
+	tick_t hundredths = (tick_t)(ticks % TICK_HZ);
+#endif
+
+	// NOTE: past the hour it shifts to HH:MM:SS, the same 8 tiles, only digits that changed get written
+	if (hours) {
+		set_stopwatch_tile(starting_bkg_xy_addr, 0, ((hours >> 4) & 0x0F) + numbers_base_tile_idx); // hours
+		set_stopwatch_tile(starting_bkg_xy_addr, 1, (hours & 0x0F) + numbers_base_tile_idx);
+
+		set_stopwatch_tile(starting_bkg_xy_addr, 3, ((minutes >> 4) & 0x0F) + numbers_base_tile_idx); // minutes
+		set_stopwatch_tile(starting_bkg_xy_addr, 4, (minutes & 0x0F) + numbers_base_tile_idx);
+
+		set_stopwatch_tile(starting_bkg_xy_addr, 6, ((seconds >> 4) & 0x0F) + numbers_base_tile_idx); // seconds
+		set_stopwatch_tile(starting_bkg_xy_addr, 7, (seconds & 0x0F) + numbers_base_tile_idx);
+		return;
+	}
+
+	set_stopwatch_tile(starting_bkg_xy_addr, 0, ((minutes >> 4) & 0x0F) + numbers_base_tile_idx); // minutes
+	set_stopwatch_tile(starting_bkg_xy_addr, 1, (minutes & 0x0F) + numbers_base_tile_idx);
+
+	set_stopwatch_tile(starting_bkg_xy_addr, 3, ((seconds >> 4) & 0x0F) + numbers_base_tile_idx); // seconds
+	set_stopwatch_tile(starting_bkg_xy_addr, 4, (seconds & 0x0F) + numbers_base_tile_idx);
+
+	uint8_t bcd_hundredths = SubsecondTable[hundredths];
+	set_stopwatch_tile(starting_bkg_xy_addr, 6, (bcd_hundredths >> 4) + numbers_base_tile_idx); // miliseconds
+	set_stopwatch_tile(starting_bkg_xy_addr, 7, (bcd_hundredths & 0x0F) + numbers_base_tile_idx);
+
+}
+
+inline void set_channel_tile(uint8_t *tiles, uint8_t *starting_bkg_xy_addr, uint8_t idx, uint8_t tile) {
+
+	if (tiles[idx] != tile) {
+		tiles[idx] = tile;
+		set_vram_byte((starting_bkg_xy_addr + idx), tile);
+	}
+
+}
+
+void print_channels(void) {
+
+	// NOTE: like print_stopwatch(), only digits that changed, a running row is ~2 writes a frame
+	for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+		uint8_t *starting_bkg_xy_addr = get_bkg_xy_addr(6, CHANNEL_ROW(i));
+		uint8_t *tiles = channel_tiles[i];
+		uint8_t m = channel_minutes[i];
+		uint8_t s = channel_seconds[i];
+		uint8_t h = SubsecondTable[channel_ticks[i]];
+
+		set_channel_tile(tiles, starting_bkg_xy_addr, 0, (m >> 4) + numbers_base_tile_idx);
+		set_channel_tile(tiles, starting_bkg_xy_addr, 1, (m & 0x0F) + numbers_base_tile_idx);
+		set_channel_tile(tiles, starting_bkg_xy_addr, 3, (s >> 4) + numbers_base_tile_idx);
+		set_channel_tile(tiles, starting_bkg_xy_addr, 4, (s & 0x0F) + numbers_base_tile_idx);
+		set_channel_tile(tiles, starting_bkg_xy_addr, 6, (h >> 4) + numbers_base_tile_idx);
+		set_channel_tile(tiles, starting_bkg_xy_addr, 7, (h & 0x0F) + numbers_base_tile_idx);
+	}
+
+}
+
+void print_time(void) {
+
+	if (screen == SCREEN_CHANNELS) print_channels();
+	else print_stopwatch();
+
+}
+
+void split_delta_clear(void) {
+
+	// NOTE: the row is blank on screen (cls / boot / just wiped), so the tiles are too
+	for (uint8_t i = 0; i < 9; i++) split_delta_tiles[i] = numbers_base_tile_idx + (' ' - '0');
+	split_delta_resync = TRUE;
+
+}
+
+void split_delta_full(void) {
+
+	stopwatch_time_t now;
+	stopwatch_snapshot(&now);
+
+	int32_t delta = (int32_t)(time_to_ticks(&now) - split_ref_next);
+	split_delta_neg = (delta < 0);
+	ticks_to_time((uint32_t)(split_delta_neg ? -delta : delta), &split_delta);
+
+	if (split_delta.hours) {
+		// NOTE: MM:SS:hh on screen, tops out at 99:59:99
+		split_delta.minutes = 0x99;
+		split_delta.seconds = 0x59;
+		split_delta.ticks = TICK_HZ - 1;
+	}
+
+	split_delta_phase = now.ticks;
+
+}
+
+void split_delta_step(tick_t ticks) {
+
+	if (!split_delta_neg) {
+		uint16_t sum = (uint16_t)split_delta.ticks + ticks; // tick_t can be a byte at 256hz
+		if (sum < TICK_HZ) {
+			split_delta.ticks = (tick_t)sum;
+			return;
+		}
+		if (split_delta.minutes == 0x99 && split_delta.seconds == 0x59) {
+			split_delta.ticks = TICK_HZ - 1; // tops out at 99:59:99 like split_delta_full(), bcd_inc() would wrap to 00
+			return;
+		}
+		split_delta.ticks = (tick_t)(sum - TICK_HZ);
+		split_delta.seconds = bcd_inc(split_delta.seconds);
+		if (split_delta.seconds == 0x60) {
+			split_delta.seconds = 0x00;
+			split_delta.minutes = bcd_inc(split_delta.minutes);
+		}
+		return;
+	}
+
+	if (!(split_delta.minutes | split_delta.seconds) && split_delta.ticks <= ticks) {
+		// caught up with the reference, behind from here
+		split_delta.ticks = ticks - split_delta.ticks;
+		split_delta_neg = FALSE;
+	} else if (split_delta.ticks >= ticks) {
+		split_delta.ticks -= ticks;
+	} else {
+		split_delta.ticks = split_delta.ticks + TICK_HZ - ticks;
+		if (split_delta.seconds) {
+			split_delta.seconds = bcd_dec(split_delta.seconds);
+		} else {
+			split_delta.seconds = 0x59;
+			split_delta.minutes = bcd_dec(split_delta.minutes);
+		}
+	}
+
+}
+
+inline void set_split_delta_tile(uint8_t *starting_bkg_xy_addr, uint8_t idx, uint8_t tile) {
+
+	// NOTE: queue full, the tile stays dirty, the compare picks it up next frame
+	if (split_delta_tiles[idx] != tile && raster_push(starting_bkg_xy_addr + idx, tile)) split_delta_tiles[idx] = tile;
+
+}
+
+void print_split_delta(void) {
+
+	uint8_t *starting_bkg_xy_addr = get_bkg_xy_addr(10, SPLIT_ROW);
+
+	raster_full = FALSE;
+
+	if (split_delta_resync) {
+		split_delta_resync = FALSE;
+		gotoxy(1, SPLIT_ROW);
+		printf(split_delta_on ? "DELTA" : "     ");
+		if (!split_delta_on) {
+			// NOTE: digits blanked through the queue too, behind anything still in it for them
+			for (uint8_t i = 0; i < 9; i++) set_split_delta_tile(starting_bkg_xy_addr, i, numbers_base_tile_idx + (' ' - '0'));
+			if (raster_full) split_delta_resync = tick_event = TRUE;
+			return;
+		}
+		split_delta_full();
+	} else if (split_delta_on) {
+		tick_t phase = stopwatch_phase();
+		split_delta_step((phase - split_delta_phase) & TICK_MASK);
+		split_delta_phase = phase;
+	} else {
+		return;
+	}
+
+	uint8_t colon_tile_idx = numbers_base_tile_idx + (':' - '0');
+	uint8_t hundredths_bcd = SubsecondTable[split_delta.ticks];
+
+	set_split_delta_tile(starting_bkg_xy_addr, 0, numbers_base_tile_idx + ((split_delta_neg ? '-' : '+') - '0'));
+	set_split_delta_tile(starting_bkg_xy_addr, 1, (split_delta.minutes >> 4) + numbers_base_tile_idx);
+	set_split_delta_tile(starting_bkg_xy_addr, 2, (split_delta.minutes & 0x0F) + numbers_base_tile_idx);
+	set_split_delta_tile(starting_bkg_xy_addr, 3, colon_tile_idx);
+	set_split_delta_tile(starting_bkg_xy_addr, 4, (split_delta.seconds >> 4) + numbers_base_tile_idx);
+	set_split_delta_tile(starting_bkg_xy_addr, 5, (split_delta.seconds & 0x0F) + numbers_base_tile_idx);
+	set_split_delta_tile(starting_bkg_xy_addr, 6, colon_tile_idx);
+	set_split_delta_tile(starting_bkg_xy_addr, 7, (hundredths_bcd >> 4) + numbers_base_tile_idx);
+	set_split_delta_tile(starting_bkg_xy_addr, 8, (hundredths_bcd & 0x0F) + numbers_base_tile_idx);
+
+	if (raster_full) tick_event = TRUE; // whatever didnt fit, next vblank even if paused
+
+}
+
+void print_split_set(void) {
+
+	gotoxy(1, 4);
+	printf("U/D SET %u REF %u  ", split_set + 1, split_ref_count);
+
+}
+
+void print_bcd_time(uint8_t *bkg_xy_addr, uint8_t bcd_minutes, uint8_t bcd_seconds, uint8_t bcd_hundredths) {
+
+	uint8_t colon_tile_idx = numbers_base_tile_idx + (':' - '0');
+
+	set_vram_byte((bkg_xy_addr), (bcd_minutes >> 4) + numbers_base_tile_idx);
+	set_vram_byte((bkg_xy_addr + 1), (bcd_minutes & 0x0F) + numbers_base_tile_idx);
+	set_vram_byte((bkg_xy_addr + 2), colon_tile_idx);
+	set_vram_byte((bkg_xy_addr + 3), (bcd_seconds >> 4) + numbers_base_tile_idx);
+	set_vram_byte((bkg_xy_addr + 4), (bcd_seconds & 0x0F) + numbers_base_tile_idx);
+	set_vram_byte((bkg_xy_addr + 5), colon_tile_idx);
+	set_vram_byte((bkg_xy_addr + 6), (bcd_hundredths >> 4) + numbers_base_tile_idx);
+	set_vram_byte((bkg_xy_addr + 7), (bcd_hundredths & 0x0F) + numbers_base_tile_idx);
+
+}
+
+void print_lap(uint16_t lap, const journal_record_t *record) {
+
+	gotoxy(1, 9);
+	printf("LAP %u    ", lap);
+	print_bcd_time(get_bkg_xy_addr(10, 9), record->minutes, record->seconds, record->hundredths);
+
+}
+
+void print_last_lap(void) {
+
+	if (!journal_count) return;
+
+	journal_record_t last_lap;
+	journal_read(journal_count - 1, &last_lap);
+	print_lap(lap_count, &last_lap);
+
+}
+
+void print_centis(uint8_t y, uint32_t centis) {
+
+	uint16_t seconds = (uint16_t)(centis / 100);
+
+	print_bcd_time(get_bkg_xy_addr(10, y),
+		bin_to_bcd((uint8_t)(seconds / 60)), bin_to_bcd((uint8_t)(seconds % 60)), bin_to_bcd((uint8_t)(centis % 100)));
+
+}
+
+void print_lap_stats(void) {
+
+	gotoxy(1, 8);
+	printf("LAPS %u", lap_stats_count);
+
+	if (!lap_stats_count) return;
+
+	gotoxy(1, 9);
+	printf("BEST %u", lap_stats_best_lap);
+	print_centis(9, lap_stats_best);
+	gotoxy(1, 10);
+	printf("WRST %u", lap_stats_worst_lap);
+	print_centis(10, lap_stats_worst);
+	gotoxy(1, 11);
+	printf("MEAN");
+	print_centis(11, (lap_stats_mean_q8 + 0x80) >> 8);
+	gotoxy(1, 12);
+	printf("SDEV");
+	print_centis(12, isqrt32(lap_stats_var));
+
+}
+
+void print_histogram_labels(void) {
+
+	gotoxy(1, 4);
+	printf("WIDTH %us   ", histo_widths[histo_width_idx]);
+
+	for (uint8_t b = 0; b < HISTO_BUCKETS; b++) {
+		// NOTE: "<" is everything under bucket 0's upper edge, ">" everything from the last one's lower edge
+		uint8_t edge_bucket = b ? b : 1;
+		gotoxy(1, HISTO_ROW + b);
+		if (!histo_anchored || histo_anchor + edge_bucket < HISTO_ANCHOR) {
+			printf("      ");
+			continue;
+		}
+		uint16_t edge = (uint16_t)((histo_anchor + edge_bucket - HISTO_ANCHOR) * histo_widths[histo_width_idx]);
+		if (edge > 5999) edge = 5999;
+		uint8_t edge_minutes = bin_to_bcd((uint8_t)(edge / 60));
+		uint8_t edge_seconds = bin_to_bcd((uint8_t)(edge % 60));
+		printf("%c%x%x:%x%x", b ? ((b == HISTO_BUCKETS - 1) ? '>' : ' ') : '<',
+			edge_minutes >> 4, edge_minutes & 0x0F, edge_seconds >> 4, edge_seconds & 0x0F);
+	}
+
+}
+
+void histo_clear(void) {
+
+	// NOTE: the rows are blank on screen after cls, tile 0, not the empty bar
+	for (uint8_t b = 0; b < HISTO_BUCKETS; b++) {
+		for (uint8_t i = 0; i < HISTO_BAR_TILES; i++) histo_tiles[b][i] = 0;
+	}
+	histo_dirty = (1 << HISTO_BUCKETS) - 1;
+
+}
+
+void print_histogram(void) {
+
+	if (!histo_dirty) return;
+
+	for (uint8_t b = 0; b < HISTO_BUCKETS; b++) {
+		uint8_t bit = 1 << b;
+		if (!(histo_dirty & bit)) continue;
+
+		uint8_t *starting_bkg_xy_addr = get_bkg_xy_addr(HISTO_BAR_X, HISTO_ROW + b);
+		uint8_t *tiles = histo_tiles[b];
+		uint16_t px = (uint16_t)histo_counts[b] * HISTO_PX_PER_LAP;
+
+		for (uint8_t i = 0; i < HISTO_BAR_TILES; i++) {
+			uint8_t fill = (px >= 8) ? 8 : (uint8_t)px;
+			px -= fill;
+			uint8_t tile = HISTO_BAR_TILE + fill;
+			if (tiles[i] == tile) continue;
+			if (!raster_push(starting_bkg_xy_addr + i, tile)) return; // rest of this bar next frame, still dirty
+			tiles[i] = tile;
+		}
+
+		histo_dirty &= ~bit;
+	}
+
+}
+
+/* ~---------------------------------------------------------------------------
+
+	LAP LIST:
+	The bkg map is 32 rows, SCY_REG wraps at 256 px, so the map is a ring that scrolls for free.
+	Lap n goes on map row n % LAPLIST_RING, then SCY_REG puts it on the last visible row: one
+	row of tiles and one register per lap, however long the list is. The LAPLIST_ROWS rows on screen
+	are always the last LAPLIST_ROWS laps written, what was there 32 laps ago is off screen.
+
+	printf cant be used for it (the console scrolls at row 17), rows go through print_tiles().
+	On entering the screen the last LAPLIST_ROWS laps are read back from the journal, once.
+
+---------------------------------------------------------------------------~ */
+
+void laplist_push(uint16_t lap, const journal_record_t *record) {
+
+	uint8_t row = (uint8_t)(laplist_count % LAPLIST_RING);
+	uint8_t *row_addr = get_bkg_xy_addr(0, row);
+	char number[] = "     ";
+
+	// NOTE: right aligned in 5, the lap count tops out at 65535
+	for (uint8_t i = 4; lap; i--) {
+		number[i] = '0' + (lap % 10);
+		lap /= 10;
+	}
+	print_tiles(row_addr, number);
+	print_bcd_time(row_addr + 10, record->minutes, record->seconds, record->hundredths);
+
+	laplist_count++;
+	SCY_REG = (laplist_count > LAPLIST_ROWS) ? (uint8_t)((laplist_count - LAPLIST_ROWS) * 8) : 0;
+
+}
+
+void laplist_enter(void) {
+
+	journal_record_t record;
+	uint16_t first = (journal_count > LAPLIST_ROWS) ? journal_count - LAPLIST_ROWS : 0;
+
+	laplist_count = first; // ring rows line up with lap numbers
+	for (uint16_t i = first; i < journal_count; i++) {
+		journal_read(i, &record);
+		laplist_push(i + 1, &record);
+	}
+
+}
+
+void laplist_leave(void) {
+
+	WY_REG = OVERLAY_WIN_Y;
+	SCY_REG = 0;
+	init_bkg(0); // the ring rows past 17, cls only clears the screen
+
+}
+
+void lap_stopwatch(void) {
+
+	stopwatch_time_t now;
+	stopwatch_time_t lap;
+
+	stopwatch_snapshot(&now);
+	uint32_t now_ticks = time_to_ticks(&now);
+	ticks_to_time(now_ticks - lap_split_ticks, &lap);
+	lap_split_ticks = now_ticks;
+	lap_count++;
+
+	if (run_split_count == lap_count - 1 && run_split_count < SPLIT_MAX) run_splits[run_split_count++] = ticks_to_centis(now_ticks);
+	split_ref_pending = TRUE; // next reference after drawing
+
+	if (lap.hours) {
+		// NOTE: a lap record is MM:SS:hh, tops out at 99:59:99 like the display used to
+		uint16_t lap_minutes = (uint16_t)bcd_to_bin(lap.hours) * 60 + bcd_to_bin(lap.minutes);
+		if (lap_minutes > 99) {
+			lap.minutes = 0x99;
+			lap.seconds = 0x59;
+			lap.ticks = TICK_HZ - 1;
+		} else {
+			lap.minutes = bin_to_bcd((uint8_t)lap_minutes);
+		}
+	}
+	lap_pending_record.minutes = lap.minutes;
+	lap_pending_record.seconds = lap.seconds;
+	lap_pending_record.hundredths = ticks_to_bcd_hundredths(lap.ticks);
+	lap_pending = TRUE; // journal_append() later, after drawing
+
+	uint8_t payload[5] = {
+		(uint8_t)lap_count, (uint8_t)(lap_count >> 8),
+		lap_pending_record.minutes, lap_pending_record.seconds, lap_pending_record.hundredths
+	};
+	telemetry_send(TELEMETRY_LAP, payload, sizeof(payload));
+
+	sfx_play(SFX_LAP);
+
+	if (screen == SCREEN_LAPS) laplist_push(lap_count, &lap_pending_record);
+	else print_lap(lap_count, &lap_pending_record);
+
+}
+
+void handle_journal(void) {
+
+	if (lap_pending) {
+		lap_pending = FALSE;
+		// NOTE: stats and histogram count what is in the journal, a lap it had no room for is left out
+		if (journal_append(&lap_pending_record)) {
+			lap_stats_insert(&lap_pending_record);
+			histo_insert(&lap_pending_record);
+		}
+#ifdef USE_RTC
+		resume_save(); // lap_split_ticks
+#endif
+	}
+
+	if (split_ref_pending) {
+		split_ref_pending = FALSE;
+		split_ref_next_load();
+	}
+
+}
+
+#ifdef USE_RTC
+
+void resume_stopwatch(void) {
+
+	resume_slot_t slot;
+	if (!resume_load(&slot)) return;
+
+	lap_split_ticks = slot.lap_split_ticks;
+	uint32_t ticks = slot.ref_ticks;
+
+	if (slot.running) {
+		resume_ref_rtc_seconds = slot.ref_rtc_seconds;
+		resume_ref_ticks = slot.ref_ticks;
+		ticks += (rtc_read_seconds() - slot.ref_rtc_seconds) * TICK_HZ + (TICK_HZ / 2); // mid second guess
+		resume_align_pending = TRUE;
+	}
+
+	stopwatch_set_ticks(ticks);
+	print_stopwatch(); // now, not next vblank
+	tick_event = FALSE;
+
+	if (slot.running) start_stopwatch();
+
+}
+
+#endif
+
+void handle_stopwatch(void) {
+
+	// NOTE: clear before drawing, a tick landing mid-draw sets it again and gets drawn next vblank
+	if (tick_event) {
+		tick_event = FALSE;
+		PROFILE_BEGIN("stopwatch render");
+		print_time();
+		if (screen == SCREEN_STOPWATCH) print_split_delta(); // queued, see RASTER
+		PROFILE_END("stopwatch render clocks: ");
+	}
+
+}
+
+void sleep_display(void) {
+
+	// NOTE: wait for release first, JOY only fires on a press, so a button still held here would
+	// look held forever and the next press of it could never wake us
+	waitpadup();
+
+	DISPLAY_OFF; // waits for vblank
+
+	// NOTE: no vblank with the LCD off, so nothing would ever step the APU off, cut it now
+	SOUND_OFF;
+	is_sound_on = FALSE;
+	sfx_stop_all();
+
+	is_lcd_off = TRUE;
+	POWER_PROFILE_RESET;
+
+}
+
+void wake_display(void) {
+
+	// NOTE: VRAM is free while the LCD is off, draw first so the very first frame is current
+	tick_event = FALSE;
+	print_time();
+	play_stopwatch_tick_sfx = FALSE; // stale, the second it was for is long gone
+	split_delta_resync = TRUE; // more than a second can have gone by unstepped
+
+	DISPLAY_ON;
+	is_lcd_off = FALSE;
+
+	if (stopwatch) sound_wake(); // tick sfx again
+
+#ifdef USE_RTC
+	rtc_prev_second = RTC_NO_SECOND; // seconds went by unpolled, the next change seen is not an edge
+#endif
+
+#ifdef PROFILE
+	EMU_printf("wake latency %u clocks", (uint16_t)(uint8_t)(DIV_REG - wake_div_start) * 256);
+#endif
+	POWER_PROFILE_RESET;
+
+}
+
+void print_calibrate_target(void) {
+
+	gotoxy(1, 4);
+	printf("U/D TARGET %uMIN  ", calibrate_target_minutes);
+
+}
+
+void print_calibrate_result(void) {
+
+	gotoxy(1, 9);
+	if (calibrate_has_result) printf("RESULT %dPPM   ", calibrate_result_ppm);
+	else printf("                  ");
+
+	gotoxy(1, 11);
+	printf("SAVED  %dPPM   ", cal_ppm);
+
+}
+
+void calibrate_measure(void) {
+
+	// NOTE: correction is off on this screen, so this is the raw crystal count
+	uint32_t target_ticks = (uint32_t)calibrate_target_minutes * 60 * TICK_HZ;
+	int32_t error_ticks = (int32_t)(stopwatch_ticks() - target_ticks);
+
+	calibrate_result_ppm = ticks_to_ppm(error_ticks, target_ticks);
+	calibrate_has_result = TRUE;
+	print_calibrate_result();
+
+}
+
+void calibrate_enter(void) {
+
+	stopwatch_set_ticks(0);
+
+	calibrate_prev_ppm = tick_corr_ppm;
+	set_tick_correction(0);
+	calibrate_has_result = FALSE;
+
+}
+
+void calibrate_leave(void) {
+
+	set_tick_correction(calibrate_prev_ppm);
+
+}
+
+void print_link_mode(void) {
+
+	gotoxy(1, 4);
+	switch (link_mode) {
+		case LINK_OFF: printf("U/D MODE OFF     "); break;
+		case LINK_MASTER: printf("U/D MODE MASTER  "); break;
+		case LINK_SLAVE: printf("U/D MODE SLAVE   "); break;
+		case LINK_TELEMETRY: printf("U/D MODE TELEMETRY"); break;
+	}
+
+}
+
+void print_link_status(void) {
+
+	gotoxy(1, 9);
+	if (link_mode == LINK_MASTER) printf(link_peer ? "PEER OK           " : "NO PEER           ");
+	else if (link_mode == LINK_SLAVE) printf(link_rx_cmd ? "MASTER OK         " : "WAITING           ");
+	else if (link_mode == LINK_TELEMETRY) printf("DROPPED %u        ", telemetry_dropped);
+	else printf("                  ");
+
+}
+
+void handle_telemetry(void) {
+
+	if (link_mode != LINK_TELEMETRY || !stopwatch) return;
+
+#ifdef TICK_COUNTER_BINARY
+	uint8_t second_mark = (uint8_t)(stopwatch_ticks() / TICK_HZ); // low byte of the whole seconds, changes once a second, read under CRITICAL
+#else
+	uint8_t second_mark = seconds;
+#endif
+	if (second_mark == telemetry_last_seconds) return;
+	telemetry_last_seconds = second_mark;
+
+	stopwatch_time_t now;
+	stopwatch_snapshot(&now);
+
+	uint8_t payload[6] = { stopwatch, now.minutes, now.seconds, TELEMETRY_TICKS(now.ticks), telemetry_dropped, now.hours };
+	telemetry_send(TELEMETRY_SNAPSHOT, payload, sizeof(payload));
+
+}
+
+void handle_link(void) {
+
+	if (!link_event) return;
+	link_event = FALSE;
+
+	// NOTE: the timer side already happened in link_isr()
+	switch (link_rx_cmd) {
+		case LINK_CMD_START: stopwatch_started(); break;
+		case LINK_CMD_STOP: stopwatch_paused(); break;
+		case LINK_CMD_RESET: reset_stopwatch(); break;
+	}
+
+	if (screen == SCREEN_LINK) print_link_status();
+
+}
+
+void print_countdown_preset(void) {
+
+	// NOTE: set in whole minutes, shown as MM:SS past the hour too
+	uint8_t preset_minutes = bin_to_bcd((uint8_t)(countdown_preset_seconds / 60));
+	uint8_t preset_seconds = bin_to_bcd((uint8_t)(countdown_preset_seconds % 60));
+
+	gotoxy(1, 4);
+	printf("SET %x%x:%x%x  U/D L/R", preset_minutes >> 4, preset_minutes & 0x0F, preset_seconds >> 4, preset_seconds & 0x0F);
+
+}
+
+void countdown_reload(void) {
+
+	stopwatch_set_ticks((uint32_t)countdown_preset_seconds * TICK_HZ);
+
+	gotoxy(1, 9);
+	printf("                  "); // time up
+
+}
+
+void print_channel_selected(void) {
+
+	for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+		gotoxy(3, CHANNEL_ROW(i));
+		printf((i == channel_selected) ? ">" : " ");
+	}
+
+}
+
+void channel_start(uint8_t idx) {
+
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		if (!stopwatch) {
+			TIMA_REG = TMA_REG; // first one in gets a whole tick, the others join mid tick
+			TAC_REG = TACF_4KHZ | TACF_START;
+			stopwatch = TRUE;
+		}
+		channel_running[idx] = TRUE;
+		DI_AUDIT_END(DI_SITE_START);
+	}
+	channels_running++;
+
+	if (channels_running == 1) POWER_PROFILE_RESET;
+	sfx_play(SFX_START_STOP);
+
+}
+
+void channel_stop(uint8_t idx) {
+
+	channels_running--;
+	CRITICAL {
+		DI_AUDIT_BEGIN;
+		channel_running[idx] = FALSE;
+		if (!channels_running) {
+			TAC_REG = TACF_STOP; // last one, no ticks to count
+			stopwatch = FALSE;
+		}
+		DI_AUDIT_END(DI_SITE_PAUSE);
+	}
+
+	if (!channels_running) POWER_PROFILE_RESET;
+	sfx_play(SFX_START_STOP);
+
+}
+
+void channel_reset(uint8_t idx) {
+
+	// NOTE: stopped, the isr skips it, no CRITICAL
+	channel_minutes[idx] = 0;
+	channel_seconds[idx] = 0;
+	channel_ticks[idx] = 0;
+
+	sfx_play(SFX_RESET);
+	tick_event = TRUE;
+
+}
+
+void handle_alarm(void) {
+
+	if (!alarm_event) return;
+	alarm_event = FALSE;
+
+	// NOTE: asleep the APU was off, the isr couldnt ring it
+	if (is_lcd_off) {
+		wake_display();
+		sfx_play(SFX_ALARM);
+	}
+
+	stopwatch_paused(); // its start / stop sfx loses to the alarm on priority
+
+	gotoxy(1, 9);
+	printf("TIME UP");
+
+#ifdef PROFILE
+	EMU_printf("countdown zero -> alarm %u clocks", (uint16_t)alarm_latency * 256);
+#endif
+
+}
+
+void set_screen(uint8_t next) {
+
+	// NOTE: only ever called stopped, the digits are drawn fresh on the next vblank
+	if (screen == SCREEN_STOPWATCH || screen == SCREEN_LAPS) stopwatch_saved_ticks = stopwatch_ticks();
+	if (screen == SCREEN_CALIBRATE) calibrate_leave();
+	if (screen == SCREEN_COUNTDOWN) countdown = FALSE;
+	if (screen == SCREEN_CHANNELS) channels = FALSE;
+	if (screen == SCREEN_LAPS) laplist_leave();
+
+	HIDE_WIN;
+	overlay_on = FALSE; // the next scene sets its own
+	raster_flush();
+
+	// NOTE: 4 stopwatches a frame / a lap row written mid-run, the histogram is only ever up while stopped
+	cpu_demand &= ~CPU_DEMAND_RENDER;
+	if (next == SCREEN_CHANNELS || next == SCREEN_LAPS) cpu_demand |= CPU_DEMAND_RENDER;
+
+	screen = next;
+	cls();
+
+	switch (screen) {
+		case SCREEN_STOPWATCH:
+			stopwatch_set_ticks(stopwatch_saved_ticks);
+			init_scene();
+			print_last_lap();
+			print_split_set();
+			split_delta_clear();
+#ifdef USE_RTC
+			print_drift();
+#endif
+			break;
+		case SCREEN_CALIBRATE:
+			calibrate_enter();
+			init_calibrate_scene();
+			print_calibrate_target();
+			print_calibrate_result();
+			break;
+		case SCREEN_COUNTDOWN:
+			countdown = TRUE;
+			countdown_reload();
+			init_countdown_scene();
+			print_countdown_preset();
+			break;
+		case SCREEN_CHANNELS:
+			channels = TRUE;
+			channel_phase = 0;
+			init_channels_scene();
+			print_channel_selected();
+			break;
+		case SCREEN_LINK:
+			stopwatch_set_ticks(stopwatch_saved_ticks);
+			init_link_scene();
+			print_link_mode();
+			print_link_status();
+			break;
+		case SCREEN_STATS:
+			stopwatch_set_ticks(stopwatch_saved_ticks);
+			init_stats_scene();
+			print_lap_stats(); // only changes on a lap, laps are only taken on the stopwatch screen
+			break;
+		case SCREEN_HISTOGRAM:
+			stopwatch_set_ticks(stopwatch_saved_ticks);
+			init_histogram_scene();
+			print_histogram_labels();
+			histo_clear(); // bars drawn over the next few vblanks
+			break;
+		case SCREEN_LAPS:
+			stopwatch_set_ticks(stopwatch_saved_ticks);
+			init_laps_scene();
+			laplist_enter();
+			break;
+	}
+
+	tick_event = TRUE;
+
+}
+
+void handle_stopwatch_inputs(uint8_t pressed) {
+
+	if (pressed & J_START) {
+		sleep_display();
+		prev_joypad = 0; // waited for release in sleep_display()
+		return;
+	}
+
+	// NOTE: master, the command goes out and both ends act on it together in link_isr()
+	if (pressed & J_A) {
+		if (link_mode == LINK_MASTER) link_send(stopwatch ? LINK_CMD_STOP : LINK_CMD_START);
+		else if (stopwatch) pause_stopwatch();
+		else start_stopwatch();
+	}
+	if (pressed & J_B) {
+		if (stopwatch) lap_stopwatch(); // laps stay local
+		else if (link_mode == LINK_MASTER) link_send(LINK_CMD_RESET);
+		else reset_stopwatch();
+	}
+
+	if (stopwatch) return; // reference sets only between runs
+
+	if (pressed & (J_UP | J_DOWN)) {
+		split_set = (split_set + ((pressed & J_DOWN) ? 1 : SPLIT_SETS - 1)) % SPLIT_SETS;
+		split_ref_load();
+		print_split_set();
+		split_ref_next_load();
+	}
+	if ((pressed & J_RIGHT) && run_split_count) {
+		split_save();
+		print_split_set();
+		split_ref_next_load();
+	}
+
+}
+
+void handle_calibrate_inputs(uint8_t pressed) {
+
+	if (pressed & J_A) {
+		if (stopwatch) {
+			pause_stopwatch();
+			calibrate_measure();
+		} else {
+			start_stopwatch();
+		}
+	}
+
+	if (stopwatch) return; // B / START / target only between runs
+
+	if (pressed & J_B) {
+		stopwatch_set_ticks(0); // not reset_stopwatch(), that starts a new lap session
+		calibrate_has_result = FALSE;
+		print_calibrate_result();
+	}
+	if ((pressed & J_START) && calibrate_has_result) {
+		calibrate_save(calibrate_result_ppm);
+		calibrate_prev_ppm = cal_ppm; // what the stopwatch screen runs with from here
+		print_calibrate_result();
+	}
+	if ((pressed & J_UP) && calibrate_target_minutes < CALIBRATE_MAX_MINUTES) {
+		calibrate_target_minutes++;
+		print_calibrate_target();
+	}
+	if ((pressed & J_DOWN) && calibrate_target_minutes > 1) {
+		calibrate_target_minutes--;
+		print_calibrate_target();
+	}
+
+}
+
+void handle_countdown_inputs(uint8_t pressed) {
+
+	if (pressed & J_START) {
+		sleep_display(); // keeps counting, the alarm wakes it
+		prev_joypad = 0;
+		return;
+	}
+
+	if (pressed & J_A) {
+		if (stopwatch) pause_stopwatch();
+#ifdef TICK_COUNTER_BINARY
+		else if (tick_count) start_stopwatch(); // at zero, B first
+#else
+		else if (hours | seconds | minutes | hundredths) start_stopwatch(); // at zero, B first
+#endif
+	}
+
+	if (stopwatch) return; // B / preset only while stopped
+
+	uint16_t preset = countdown_preset_seconds;
+	if (pressed & J_UP) preset += 60;
+	if ((pressed & J_DOWN) && preset > 60) preset -= 60;
+	if (pressed & J_RIGHT) preset += 10;
+	if ((pressed & J_LEFT) && preset > 10) preset -= 10;
+	if (preset > COUNTDOWN_MAX_SECONDS) preset = COUNTDOWN_MAX_SECONDS;
+
+	if (preset != countdown_preset_seconds) {
+		countdown_preset_seconds = preset;
+		print_countdown_preset();
+		countdown_reload();
+	} else if (pressed & J_B) {
+		countdown_reload();
+	}
+
+}
+
+void handle_channels_inputs(uint8_t pressed) {
+
+	if (pressed & J_START) {
+		sleep_display(); // every running channel keeps counting
+		prev_joypad = 0;
+		return;
+	}
+
+	if (pressed & (J_UP | J_DOWN)) {
+		channel_selected = (channel_selected + ((pressed & J_DOWN) ? 1 : CHANNEL_COUNT - 1)) % CHANNEL_COUNT;
+		print_channel_selected();
+	}
+
+	if (pressed & J_A) {
+		if (channel_running[channel_selected]) channel_stop(channel_selected);
+		else channel_start(channel_selected);
+	}
+	if ((pressed & J_B) && !channel_running[channel_selected]) channel_reset(channel_selected);
+
+}
+
+void handle_link_inputs(uint8_t pressed) {
+
+	if (pressed & (J_UP | J_DOWN)) {
+		uint8_t mode = link_mode + ((pressed & J_UP) ? 1 : LINK_MODE_COUNT - 1);
+		set_link_mode(mode % LINK_MODE_COUNT);
+		print_link_mode();
+		print_link_status();
+	}
+	if (pressed & J_A) link_send(LINK_CMD_PING);
+
+}
+
+void histo_rebuild(void) {
+
+	// NOTE: only from a button press, reads the whole session back from the journal
+	journal_record_t record;
+
+	histo_reset();
+	for (uint16_t i = 0; i < journal_count; i++) {
+		journal_read(i, &record);
+		histo_insert(&record);
+	}
+
+}
+
+void handle_histogram_inputs(uint8_t pressed) {
+
+	if (pressed & (J_LEFT | J_RIGHT)) {
+		histo_width_idx = (histo_width_idx + ((pressed & J_RIGHT) ? 1 : HISTO_WIDTHS - 1)) % HISTO_WIDTHS;
+		histo_rebuild();
+		print_histogram_labels();
+	}
+
+}
+
+void handle_laps_inputs(uint8_t pressed) {
+
+	// NOTE: local only, the link follows the stopwatch screen
+	if (pressed & J_A) {
+		if (stopwatch) pause_stopwatch();
+		else start_stopwatch();
+	}
+	if ((pressed & J_B) && stopwatch) lap_stopwatch();
+
+}
+
+void handle_inputs(void) {
+
+	joy_event = FALSE;
+
+	uint8_t current_joypad = joypad();
+	uint8_t pressed = current_joypad & ~prev_joypad;
+	prev_joypad = current_joypad;
+
+	// NOTE: asleep, any button just wakes the display, the press is not passed on
+	if (is_lcd_off) {
+		if (current_joypad) wake_display();
+		return;
+	}
+
+	if ((pressed & J_SELECT) && !stopwatch) {
+		set_screen((screen + 1) % SCREEN_COUNT);
+		return;
+	}
+
+	switch (screen) {
+		case SCREEN_STOPWATCH: handle_stopwatch_inputs(pressed); break;
+		case SCREEN_COUNTDOWN: handle_countdown_inputs(pressed); break;
+		case SCREEN_CHANNELS: handle_channels_inputs(pressed); break;
+		case SCREEN_CALIBRATE: handle_calibrate_inputs(pressed); break;
+		case SCREEN_LINK: handle_link_inputs(pressed); break;
+		case SCREEN_HISTOGRAM: handle_histogram_inputs(pressed); break;
+		case SCREEN_LAPS: handle_laps_inputs(pressed); break;
+	}
+
+}
+
+void handle_sound(void) {
+
+	// NOTE: APU off once the last sfx has rung out, never while running (tick sfx every second)
+	if (is_sound_on && !stopwatch) {
+		if (--sound_tail_frames == 0) {
+			SOUND_OFF;
+			is_sound_on = FALSE;
+			sfx_stop_all();
+		}
+	}
+
+}
+
+void handle_cpu_speed(void) {
+
+	// NOTE: normal speed when idle or paused, double speed only while something asks for it
+	if (is_gbc) {
+		set_cpu_speed(stopwatch && (cpu_demand & (CPU_DEMAND_RENDER | CPU_DEMAND_HIRES)));
+	}
+
+}
+
+void handle_power(void) {
+
+	// NOTE: with the LCD off a stale tick_event never gets drawn, dont let it keep us awake
+	bool drawing = tick_event || (screen == SCREEN_HISTOGRAM && histo_dirty) || (raster_head != raster_tail);
+	bool idle = !stopwatch && !prev_joypad && !is_sound_on && (is_lcd_off || !drawing);
+	uint8_t ie = idle ? IE_IDLE : (is_lcd_off ? IE_LCD_OFF : IE_ACTIVE);
+
+	if (ie != power_ie) {
+		power_ie = ie;
+		set_interrupts(ie);
+	}
+
+	// NOTE: no vblank to poll on, select both button groups so any press pulls a P1 line low and fires JOY
+	if (!(power_ie & VBL_IFLAG)) P1_REG = 0x00;
+
+}
+
+void wait_for_event(void) {
+
+#ifdef PROFILE
+	// spin instead of HALT, see POWER in PROFILE notes
+	while (!(vbl_event || joy_event || link_event || alarm_event)) {
+		uint8_t div_now = DIV_REG;
+		power_spins++;
+		if (div_now < power_div_prev) {
+			if (++power_div_wraps == power_window_wraps) power_report();
+		}
+		power_div_prev = div_now;
+	}
+#else
+	// NOTE: IME stays off from the check through the HALT, otherwise an interrupt landing between
+	// the check and the HALT is serviced first and the HALT then sleeps with its event already set.
+	// HALT still wakes on IE & IF with IME off, the EI after it services the interrupt, and the loop
+	// checks again. Already pending with IME off, HALT falls straight through (and the DMG runs the
+	// next byte twice, the NOP, harmless).
+	while (TRUE) {
+		disable_interrupts();
+		if (vbl_event || joy_event || link_event || alarm_event) break;
+		__asm__("halt\n nop");
+		enable_interrupts();
+	}
+	enable_interrupts();
+#endif
+
+}
+
+//* ------------------------------------------------------------------------------------------- *//
+//* -----------------------------------------  GAME  ------------------------------------------ *//
+//* ------------------------------------------------------------------------------------------- *//
+
+void init_game(void) {
+
+	font_init();
+	font = font_load(font_spect);
+	set_bkg_data(HISTO_BAR_TILE, 9, histo_bar_tiles);
+
+	set_timer_reg_stopwatch(); // set counter and modulo registers
+	set_timer_isr_stopwatch(); // set isr
+	TIMA_REG = 0; // reset TIMA_REG
+	set_link_isr(); // link_mode starts off, the isr ignores everything until it is set
+
+#if TICK_HZ >= TICK_HZ_HIRES
+	cpu_demand |= CPU_DEMAND_HIRES;
+#endif
+
+	init_scene(); // header and controls text
+
+	sram_format_check(); // first boot on a cart, before anything reads SRAM
+
+#ifdef USE_RTC
+	rtc_init();
+	resume_stopwatch(); // before the journal scan, that one can take a few frames
+#endif
+
+	journal_recover(); // laps from before power off
+	calibrate_load();
+	lap_count = journal_count;
+	print_last_lap();
+
+	// NOTE: once at boot, the session's laps from the journal, one insert each
+	journal_record_t record;
+	histo_reset();
+	for (uint16_t i = 0; i < journal_count; i++) {
+		journal_read(i, &record);
+		lap_stats_insert(&record);
+		histo_insert(&record);
+	}
+
+	split_ref_load();
+	print_split_set();
+	split_delta_clear();
+	split_ref_next_load(); // off until a reset, if laps came back from the journal
+
+#ifdef USE_RTC
+	print_drift(); // the calibration, until the RTC has measured
+#endif
+
+}
+
+//* ------------------------------------------------------------------------------------------- *//
+//* -----------------------------------------  MAIN  ------------------------------------------ *//
+//* ------------------------------------------------------------------------------------------- *//
+
+void main(void) {
+
+	init_system();
+	init_game();
+
+	while (TRUE) {
+		wait_for_event(); // HALT until vblank, a button press or a link command, timer ticks alone go back to sleep
+		handle_inputs();
+
+		if (vbl_event) {
+			vbl_event = FALSE;
+			handle_stopwatch();
+			if (screen == SCREEN_HISTOGRAM) print_histogram();
+			handle_sound();
+#ifdef USE_RTC
+			if (screen == SCREEN_STOPWATCH || screen == SCREEN_LAPS) handle_rtc(); // both run the stopwatch, calibrate wants the raw crystal
+#endif
+		}
+
+		handle_alarm();
+		handle_link(); // before the journal, a reset over the link starts a new session
+		handle_telemetry();
+		handle_journal(); // after drawing, never in the way of a frame
+
+		handle_cpu_speed();
+		handle_power(); // pick what can wake us next
+
+#ifdef PROFILE
+		handle_profile();
+#endif
 	}
 
 }
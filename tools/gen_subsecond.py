@@ -0,0 +1,54 @@
+#!/usr/bin/env python3
+# ============================================================  gen subsecond  ====================
+#
+# Writes the tick -> hundredths table for one tick rate, packed BCD, one byte per tick,
+# see SubsecondTable in main.c.
+# `make` runs it with TICK_HZ into build/gen/subsecond.c, which is compiled next to main.c:
+#
+#   python3 tools/gen_subsecond.py 256 > build/gen/subsecond.c
+#
+# Entry i is the hundredths shown i ticks into a second, truncated, floor(i * 100 / TICK_HZ),
+# same as the MilTable128 that used to be generated by hand in RGBASM.
+
+import argparse
+
+# NOTE: power of 2 so the isr wraps with a mask, 4096 / TICK_HZ and 8192 / TICK_HZ both fit TMA_REG
+TICK_HZ_RATES = (32, 64, 128, 256, 512, 1024)
+
+PER_LINE = 16
+
+
+def table(tick_hz):
+	return [i * 100 // tick_hz for i in range(tick_hz)]
+
+
+def render(tick_hz):
+	entries = ["0x%u%u" % (hundredths // 10, hundredths % 10) for hundredths in table(tick_hz)]
+	rows = [", ".join(entries[i:i + PER_LINE]) for i in range(0, len(entries), PER_LINE)]
+
+	out = []
+	out.append("// generated by tools/gen_subsecond.py %u, do not edit" % tick_hz)
+	out.append("")
+	out.append("#if TICK_HZ != %u" % tick_hz)
+	out.append("#error \"subsecond.c was generated for %u hz, run make again\"" % tick_hz)
+	out.append("#endif")
+	out.append("")
+	out.append("#include <stdint.h>")
+	out.append("")
+	out.append("// NOTE: const, lands in ROM")
+	out.append("const uint8_t SubsecondTable[%u] = {" % tick_hz)
+	out.append(",\n".join("\t" + row for row in rows))
+	out.append("};")
+	return "\n".join(out) + "\n"
+
+
+def main():
+	parser = argparse.ArgumentParser(description="generate the gb-stopwatch tick -> hundredths table")
+	parser.add_argument("tick_hz", type=int, choices=TICK_HZ_RATES, help="timer ticks per second")
+	args = parser.parse_args()
+
+	print(render(args.tick_hz), end="")
+
+
+if __name__ == "__main__":
+	main()
@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# ============================================================  telemetry rx  =====================
+#
+# Decodes the link port telemetry stream (link screen, mode TELEMETRY), see TELEMETRY in main.c.
+#
+#   frame: SOF (0xA5) | type | length | payload ... | check
+#   check: ~(type + length + payload), 8 bit
+#
+# The Game Boy drives the clock, whatever sits on the other end of the cable (a serial adapter,
+# an emulator link dump) just has to hand over the raw bytes, from a file, a tty, or stdin:
+#
+#   python3 tools/telemetry_rx.py /dev/ttyACM0
+#   python3 tools/telemetry_rx.py capture.bin --csv > session.csv
+#
+# Bad checks and stray bytes are skipped, it resyncs on the next SOF.
+
+import argparse
+import sys
+
+SOF = 0xA5
+FRAME_OVERHEAD = 4
+MAX_PAYLOAD = 16 # longest the ROM sends is 6, anything past this was never a real length
+
+TELEMETRY_SNAPSHOT = 0x01
+TELEMETRY_LAP = 0x02
+TELEMETRY_EVENT = 0x03
+
+EVENTS = {0x01: "start", 0x02: "stop", 0x03: "reset"}
+
+TICK_HZ = 128
+
+
+def bcd(value):
+	return (value >> 4) * 10 + (value & 0x0F)
+
+
+def ticks_time(minutes, seconds, ticks, hours):
+	if hours:
+		return "%u:%02u:%02u.%03u" % (bcd(hours), bcd(minutes), bcd(seconds), ticks * 1000 // TICK_HZ)
+	return "%02u:%02u.%03u" % (bcd(minutes), bcd(seconds), ticks * 1000 // TICK_HZ)
+
+
+def hundredths_time(minutes, seconds, hundredths):
+	return "%02u:%02u.%02u" % (bcd(minutes), bcd(seconds), bcd(hundredths))
+
+
+def decode(frame_type, payload):
+	if frame_type == TELEMETRY_SNAPSHOT and len(payload) == 6:
+		running, minutes, seconds, ticks, dropped, hours = payload
+		return "snapshot", ticks_time(minutes, seconds, ticks, hours), "running=%u dropped=%u" % (running, dropped)
+	if frame_type == TELEMETRY_LAP and len(payload) == 5:
+		lap = payload[0] | (payload[1] << 8)
+		return "lap", hundredths_time(*payload[2:5]), "lap=%u" % lap
+	if frame_type == TELEMETRY_EVENT and len(payload) == 5:
+		event = EVENTS.get(payload[0], "event %02x" % payload[0])
+		return event, ticks_time(*payload[1:5]), ""
+	return "unknown %02x" % frame_type, "", payload.hex()
+
+
+def frames(stream):
+	buf = bytearray()
+	while True:
+		chunk = stream.read(1)
+		if not chunk:
+			return
+		buf += chunk
+
+		# NOTE: a false SOF can hide a real frame behind it, keep going until more bytes are needed
+		while True:
+			while buf and buf[0] != SOF:
+				del buf[0]
+			if len(buf) >= 3 and buf[2] > MAX_PAYLOAD:
+				del buf[0]
+				continue
+			if len(buf) < 3 or len(buf) < buf[2] + FRAME_OVERHEAD:
+				break
+
+			length = buf[2]
+			frame_type = buf[1]
+			payload = bytes(buf[3:3 + length])
+			check = (~(frame_type + length + sum(payload))) & 0xFF
+
+			if buf[3 + length] == check:
+				del buf[:length + FRAME_OVERHEAD]
+				yield frame_type, payload
+			else:
+				del buf[0] # not a frame after all, look for the next SOF
+
+
+def main():
+	parser = argparse.ArgumentParser(description="decode gb-stopwatch link telemetry")
+	parser.add_argument("source", nargs="?", default="-", help="file / tty with the raw bytes, - for stdin")
+	parser.add_argument("--csv", action="store_true", help="kind,time,info lines instead of columns")
+	args = parser.parse_args()
+
+	stream = sys.stdin.buffer if args.source == "-" else open(args.source, "rb", buffering=0)
+
+	if args.csv:
+		print("kind,time,info")
+	for frame_type, payload in frames(stream):
+		kind, time, info = decode(frame_type, payload)
+		if args.csv:
+			print("%s,%s,%s" % (kind, time, info))
+		else:
+			print("%-10s %-10s %s" % (kind, time, info))
+		sys.stdout.flush()
+
+
+if __name__ == "__main__":
+	main()